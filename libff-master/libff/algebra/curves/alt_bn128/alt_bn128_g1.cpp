@@ -390,6 +390,11 @@ bool alt_bn128_G1::is_well_formed() const
     }
 }
 
+bool alt_bn128_G1::is_in_subgroup() const
+{
+    return this->is_well_formed();
+}
+
 alt_bn128_G1 alt_bn128_G1::zero()
 {
     return G1_zero;
@@ -524,4 +529,87 @@ void alt_bn128_G1::batch_to_special_all_non_zeros(std::vector<alt_bn128_G1> &vec
     }
 }
 
+/* a if choose_b is false and b otherwise, without branching on choose_b */
+static alt_bn128_Fq alt_bn128_Fq_select(const bool choose_b, const alt_bn128_Fq &a, const alt_bn128_Fq &b)
+{
+    const mp_limb_t mask = -(mp_limb_t)choose_b;
+    alt_bn128_Fq result;
+    for (size_t i = 0; i < alt_bn128_q_limbs; ++i)
+    {
+        result.mont_repr.data[i] = a.mont_repr.data[i] ^ (mask & (a.mont_repr.data[i] ^ b.mont_repr.data[i]));
+    }
+    return result;
+}
+
+/* whether x is a square, zero included */
+static bool alt_bn128_Fq_is_square(const alt_bn128_Fq &x)
+{
+    return ((x^alt_bn128_Fq::euler) != -alt_bn128_Fq::one());
+}
+
+/* steps 1-6 of the map: tv3 is the element to invert */
+static void alt_bn128_svdw_map_start(const alt_bn128_Fq &u, alt_bn128_Fq &tv1, alt_bn128_Fq &tv2, alt_bn128_Fq &tv3)
+{
+    tv1 = u.squared() * alt_bn128_svdw_c1;
+    tv2 = alt_bn128_Fq::one() + tv1;
+    tv1 = alt_bn128_Fq::one() - tv1;
+    tv3 = tv1 * tv2;
+}
+
+/* the remaining steps, given tv3_inv = tv3^(-1), or zero if tv3 is zero */
+static alt_bn128_G1 alt_bn128_svdw_map_finish(const alt_bn128_Fq &u, const alt_bn128_Fq &tv1,
+                                              const alt_bn128_Fq &tv2, const alt_bn128_Fq &tv3_inv)
+{
+    const alt_bn128_Fq tv4 = u * tv1 * tv3_inv * alt_bn128_svdw_c3;
+
+    const alt_bn128_Fq x1 = alt_bn128_svdw_c2 - tv4;
+    const bool e1 = alt_bn128_Fq_is_square(x1.squared() * x1 + alt_bn128_coeff_b);
+    const alt_bn128_Fq x2 = alt_bn128_svdw_c2 + tv4;
+    const bool e2 = alt_bn128_Fq_is_square(x2.squared() * x2 + alt_bn128_coeff_b) && !e1;
+    const alt_bn128_Fq x3 = (tv2.squared() * tv3_inv).squared() * alt_bn128_svdw_c4 + alt_bn128_Fq::one();
+
+    /* at least one of g(x1), g(x2) and g(x3) is a square */
+    alt_bn128_Fq x = alt_bn128_Fq_select(e1, x3, x1);
+    x = alt_bn128_Fq_select(e2, x, x2);
+    const alt_bn128_Fq gx = x.squared() * x + alt_bn128_coeff_b;
+
+    /* q = 3 mod 4, so sqrt(gx) = gx^((q+1)/4), and the sign of y is that of u */
+    alt_bn128_Fq y = (gx^alt_bn128_Fq::t_minus_1_over_2) * gx;
+    const bool same_sign = (((u.as_bigint().data[0] ^ y.as_bigint().data[0]) & 1) == 0);
+    y = alt_bn128_Fq_select(same_sign, -y, y);
+
+    return alt_bn128_G1(x, y, alt_bn128_Fq::one());
+}
+
+alt_bn128_G1 alt_bn128_G1::map_to_curve(const alt_bn128_Fq &u)
+{
+    return batch_map_to_curve(std::vector<alt_bn128_Fq>(1, u))[0];
+}
+
+std::vector<alt_bn128_G1> alt_bn128_G1::batch_map_to_curve(const std::vector<alt_bn128_Fq> &u)
+{
+    const size_t n = u.size();
+    std::vector<alt_bn128_Fq> tv1(n), tv2(n), tv3(n);
+    std::vector<bool> tv3_is_zero(n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        alt_bn128_svdw_map_start(u[i], tv1[i], tv2[i], tv3[i]);
+        /* only for u^2 = +-1/4; invert one instead and map to x3 = Z */
+        tv3_is_zero[i] = tv3[i].is_zero();
+        tv3[i] = alt_bn128_Fq_select(tv3_is_zero[i], tv3[i], alt_bn128_Fq::one());
+    }
+    batch_invert<alt_bn128_Fq>(tv3);
+
+    std::vector<alt_bn128_G1> result;
+    result.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        const alt_bn128_Fq tv3_inv = alt_bn128_Fq_select(tv3_is_zero[i], tv3[i], alt_bn128_Fq::zero());
+        result.emplace_back(alt_bn128_svdw_map_finish(u[i], tv1[i], tv2[i], tv3_inv));
+    }
+
+    return result;
+}
+
 } // libff
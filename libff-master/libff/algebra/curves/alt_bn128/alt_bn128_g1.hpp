@@ -60,6 +60,8 @@ public:
     alt_bn128_G1 dbl() const;
 
     bool is_well_formed() const;
+    /* G1 is the whole curve (cofactor 1), so this is is_well_formed() */
+    bool is_in_subgroup() const;
 
     static alt_bn128_G1 zero();
     static alt_bn128_G1 one();
@@ -73,6 +75,17 @@ public:
     friend std::istream& operator>>(std::istream &in, alt_bn128_G1 &g);
 
     static void batch_to_special_all_non_zeros(std::vector<alt_bn128_G1> &vec);
+
+    /*
+      Shallue--van de Woestijne map of u to the curve (RFC 9380, section 6.6.1),
+      in affine coordinates. The candidates are chosen with branch-free selects,
+      but the field inversion is GMP's, so the map is not constant-time.
+      hash_to_curve(msg) is map_to_curve(u0) + map_to_curve(u1) for (u0, u1) the
+      hash of msg to two field elements.
+    */
+    static alt_bn128_G1 map_to_curve(const alt_bn128_Fq &u);
+    /* the same for every element of u, with one field inversion in total */
+    static std::vector<alt_bn128_G1> batch_map_to_curve(const std::vector<alt_bn128_Fq> &u);
 };
 
 template<mp_size_t m>
@@ -404,6 +404,31 @@ bool alt_bn128_G2::is_well_formed() const
     }
 }
 
+bool alt_bn128_G2::is_in_subgroup() const
+{
+    if (!this->is_well_formed())
+    {
+        return false;
+    }
+
+    /*
+      psi = mul_by_q acts on G2 as multiplication by q, and
+      (z+1) + z*q + z*q^2 - 2z*q^3 = 0 (mod r). Conversely, on the other
+      prime-order components of the twist (all of multiplicity one) this
+      combination of psi has no kernel, so checking
+
+      Q + [z]Q + psi([z]Q) + psi^2([z]Q) == psi^3([2z]Q)
+
+      is enough, and costs one 63-bit scalar multiplication instead of [r]Q.
+    */
+    assert(!alt_bn128_final_exponent_is_z_neg);
+    const alt_bn128_G2 zQ = alt_bn128_final_exponent_z * (*this);
+    const alt_bn128_G2 zQ_q = zQ.mul_by_q();
+    const alt_bn128_G2 zQ_q2 = zQ_q.mul_by_q();
+
+    return (*this + zQ + zQ_q + zQ_q2 == zQ_q2.mul_by_q().dbl());
+}
+
 alt_bn128_G2 alt_bn128_G2::zero()
 {
     return G2_zero;
@@ -64,6 +64,8 @@ public:
     alt_bn128_G2 mul_by_q() const;
 
     bool is_well_formed() const;
+    /* is_well_formed() and of order r, using the endomorphism mul_by_q() */
+    bool is_in_subgroup() const;
 
     static alt_bn128_G2 zero();
     static alt_bn128_G2 one();
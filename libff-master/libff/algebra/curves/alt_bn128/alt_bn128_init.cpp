@@ -8,12 +8,32 @@
 #include <libff/algebra/curves/alt_bn128/alt_bn128_g1.hpp>
 #include <libff/algebra/curves/alt_bn128/alt_bn128_g2.hpp>
 #include <libff/algebra/curves/alt_bn128/alt_bn128_init.hpp>
+#include <libff/algebra/scalar_multiplication/wnaf.hpp>
+#ifdef ALT_BN128_ATE_PAIRING
+#include <algorithm>
+#include <stdexcept>
+
+#include "depends/ate-pairing/include/bn.h"
+
+#ifndef BN_SUPPORT_SNARK
+#error "ALT_BN128_ATE_PAIRING needs ate-pairing built with BN_SUPPORT_SNARK"
+#endif
+#endif
 
 namespace libff {
 
 bigint<alt_bn128_r_limbs> alt_bn128_modulus_r;
 bigint<alt_bn128_q_limbs> alt_bn128_modulus_q;
 
+#if GMP_NUMB_BITS == 64 && defined(__SIZEOF_INT128__)
+constexpr bigint<alt_bn128_r_limbs> fp_constexpr_params<alt_bn128_r_limbs, alt_bn128_modulus_r>::modulus;
+constexpr bigint<alt_bn128_r_limbs> fp_constexpr_params<alt_bn128_r_limbs, alt_bn128_modulus_r>::Rsquared;
+constexpr bigint<alt_bn128_r_limbs> fp_constexpr_params<alt_bn128_r_limbs, alt_bn128_modulus_r>::Rcubed;
+constexpr bigint<alt_bn128_q_limbs> fp_constexpr_params<alt_bn128_q_limbs, alt_bn128_modulus_q>::modulus;
+constexpr bigint<alt_bn128_q_limbs> fp_constexpr_params<alt_bn128_q_limbs, alt_bn128_modulus_q>::Rsquared;
+constexpr bigint<alt_bn128_q_limbs> fp_constexpr_params<alt_bn128_q_limbs, alt_bn128_modulus_q>::Rcubed;
+#endif
+
 alt_bn128_Fq alt_bn128_coeff_b;
 alt_bn128_Fq2 alt_bn128_twist;
 alt_bn128_Fq2 alt_bn128_twist_coeff_b;
@@ -22,8 +42,14 @@ alt_bn128_Fq alt_bn128_twist_mul_by_b_c1;
 alt_bn128_Fq2 alt_bn128_twist_mul_by_q_X;
 alt_bn128_Fq2 alt_bn128_twist_mul_by_q_Y;
 
+alt_bn128_Fq alt_bn128_svdw_c1;
+alt_bn128_Fq alt_bn128_svdw_c2;
+alt_bn128_Fq alt_bn128_svdw_c3;
+alt_bn128_Fq alt_bn128_svdw_c4;
+
 bigint<alt_bn128_q_limbs> alt_bn128_ate_loop_count;
 bool alt_bn128_ate_is_loop_count_neg;
+std::vector<long> alt_bn128_ate_loop_naf;
 bigint<12*alt_bn128_q_limbs> alt_bn128_final_exponent;
 bigint<alt_bn128_q_limbs> alt_bn128_final_exponent_z;
 bool alt_bn128_final_exponent_is_z_neg;
@@ -37,8 +63,14 @@ void init_alt_bn128_params()
 
     /* parameters for scalar field Fr */
 
+#if GMP_NUMB_BITS == 64 && defined(__SIZEOF_INT128__)
+    typedef fp_constexpr_params<alt_bn128_r_limbs, alt_bn128_modulus_r> params_r;
+    alt_bn128_modulus_r = params_r::modulus;
+    alt_bn128_Fr::Rsquared = params_r::Rsquared;
+    alt_bn128_Fr::Rcubed = params_r::Rcubed;
+    alt_bn128_Fr::inv = params_r::inv;
+#else
     alt_bn128_modulus_r = bigint_r("21888242871839275222246405745257275088548364400416034343698204186575808495617");
-    assert(alt_bn128_Fr::modulus_is_valid());
     if (sizeof(mp_limb_t) == 8)
     {
         alt_bn128_Fr::Rsquared = bigint_r("944936681149208446651664254269745548490766851729442924617792859073125903783");
@@ -51,6 +83,9 @@ void init_alt_bn128_params()
         alt_bn128_Fr::Rcubed = bigint_r("5866548545943845227489894872040244720403868105578784105281690076696998248512");
         alt_bn128_Fr::inv = 0xefffffff;
     }
+#endif
+    assert(alt_bn128_Fr::modulus_is_valid());
+    alt_bn128_Fr::init_jit();
     alt_bn128_Fr::num_bits = 254;
     alt_bn128_Fr::euler = bigint_r("10944121435919637611123202872628637544274182200208017171849102093287904247808");
     alt_bn128_Fr::s = 28;
@@ -63,8 +98,14 @@ void init_alt_bn128_params()
 
     /* parameters for base field Fq */
 
+#if GMP_NUMB_BITS == 64 && defined(__SIZEOF_INT128__)
+    typedef fp_constexpr_params<alt_bn128_q_limbs, alt_bn128_modulus_q> params_q;
+    alt_bn128_modulus_q = params_q::modulus;
+    alt_bn128_Fq::Rsquared = params_q::Rsquared;
+    alt_bn128_Fq::Rcubed = params_q::Rcubed;
+    alt_bn128_Fq::inv = params_q::inv;
+#else
     alt_bn128_modulus_q = bigint_q("21888242871839275222246405745257275088696311157297823662689037894645226208583");
-    assert(alt_bn128_Fq::modulus_is_valid());
     if (sizeof(mp_limb_t) == 8)
     {
         alt_bn128_Fq::Rsquared = bigint_q("3096616502983703923843567936837374451735540968419076528771170197431451843209");
@@ -77,6 +118,9 @@ void init_alt_bn128_params()
         alt_bn128_Fq::Rcubed = bigint_q("14921786541159648185948152738563080959093619838510245177710943249661917737183");
         alt_bn128_Fq::inv = 0xe4866389;
     }
+#endif
+    assert(alt_bn128_Fq::modulus_is_valid());
+    alt_bn128_Fq::init_jit();
     alt_bn128_Fq::num_bits = 254;
     alt_bn128_Fq::euler = bigint_q("10944121435919637611123202872628637544348155578648911831344518947322613104291");
     alt_bn128_Fq::s = 1;
@@ -97,6 +141,7 @@ void init_alt_bn128_params()
     alt_bn128_Fq2::nqr_to_t = alt_bn128_Fq2(alt_bn128_Fq("5033503716262624267312492558379982687175200734934877598599011485707452665730"),alt_bn128_Fq("314498342015008975724433667930697407966947188435857772134235984660852259084"));
     alt_bn128_Fq2::Frobenius_coeffs_c1[0] = alt_bn128_Fq("1");
     alt_bn128_Fq2::Frobenius_coeffs_c1[1] = alt_bn128_Fq("21888242871839275222246405745257275088696311157297823662689037894645226208582");
+    alt_bn128_Fq2::init_lazy_reduction();
 
     /* parameters for Fq6 */
     alt_bn128_Fq6::non_residue = alt_bn128_Fq2(alt_bn128_Fq("9"),alt_bn128_Fq("1"));
@@ -112,6 +157,7 @@ void init_alt_bn128_params()
     alt_bn128_Fq6::Frobenius_coeffs_c2[3] = alt_bn128_Fq2(alt_bn128_Fq("5324479202449903542726783395506214481928257762400643279780343368557297135718"),alt_bn128_Fq("16208900380737693084919495127334387981393726419856888799917914180988844123039"));
     alt_bn128_Fq6::Frobenius_coeffs_c2[4] = alt_bn128_Fq2(alt_bn128_Fq("21888242871839275220042445260109153167277707414472061641714758635765020556616"),alt_bn128_Fq("0"));
     alt_bn128_Fq6::Frobenius_coeffs_c2[5] = alt_bn128_Fq2(alt_bn128_Fq("13981852324922362344252311234282257507216387789820983642040889267519694726527"),alt_bn128_Fq("7629828391165209371577384193250820201684255241773809077146787135900891633097"));
+    alt_bn128_Fq6::init_lazy_reduction();
 
     /* parameters for Fq12 */
 
@@ -141,6 +187,11 @@ void init_alt_bn128_params()
     alt_bn128_twist_mul_by_q_Y = alt_bn128_Fq2(alt_bn128_Fq("2821565182194536844548159561693502659359617185244120367078079554186484126554"),
                                            alt_bn128_Fq("3505843767911556378687030309984248845540243509899259641013678093033130930403"));
 
+    alt_bn128_svdw_c1 = alt_bn128_Fq("4");
+    alt_bn128_svdw_c2 = alt_bn128_Fq("10944121435919637611123202872628637544348155578648911831344518947322613104291");
+    alt_bn128_svdw_c3 = alt_bn128_Fq("8815841940592487685674414971303048083897117035520822607866");
+    alt_bn128_svdw_c4 = alt_bn128_Fq("7296080957279758407415468581752425029565437052432607887563012631548408736189");
+
     /* choice of group G1 */
     alt_bn128_G1::G1_zero = alt_bn128_G1(alt_bn128_Fq::zero(),
                                      alt_bn128_Fq::one(),
@@ -271,9 +322,26 @@ void init_alt_bn128_params()
 
     alt_bn128_ate_loop_count = bigint_q("29793968203157093288");
     alt_bn128_ate_is_loop_count_neg = false;
+    alt_bn128_ate_loop_naf = find_wnaf(1, alt_bn128_ate_loop_count);
+    while (alt_bn128_ate_loop_naf.back() == 0)
+    {
+        alt_bn128_ate_loop_naf.pop_back();
+    }
     alt_bn128_final_exponent = bigint<12*alt_bn128_q_limbs>("552484233613224096312617126783173147097382103762957654188882734314196910839907541213974502761540629817009608548654680343627701153829446747810907373256841551006201639677726139946029199968412598804882391702273019083653272047566316584365559776493027495458238373902875937659943504873220554161550525926302303331747463515644711876653177129578303191095900909191624817826566688241804408081892785725967931714097716709526092261278071952560171111444072049229123565057483750161460024353346284167282452756217662335528813519139808291170539072125381230815729071544861602750936964829313608137325426383735122175229541155376346436093930287402089517426973178917569713384748081827255472576937471496195752727188261435633271238710131736096299798168852925540549342330775279877006784354801422249722573783561685179618816480037695005515426162362431072245638324744480");
     alt_bn128_final_exponent_z = bigint_q("4965661367192848881");
     alt_bn128_final_exponent_is_z_neg = false;
 
+#ifdef ALT_BN128_ATE_PAIRING
+    /* Miller loops and final exponentiations run on the ate-pairing library,
+       whose Fq elements are converted to and from ours by copying limbs */
+    static_assert(alt_bn128_q_limbs == bn::Fp::N, "ate-pairing Fp must have as many limbs as alt_bn128_Fq");
+    bn::Param::init(bn::CurveSNARK1);
+    const alt_bn128_Fq one = alt_bn128_Fq::one();
+    if (bn::Fp::getModulo() != mie::Vuint(alt_bn128_modulus_q.data, alt_bn128_q_limbs) ||
+        !std::equal(one.mont_repr.data, one.mont_repr.data + alt_bn128_q_limbs, &bn::Fp(1)[0]))
+    {
+        throw std::runtime_error("init_alt_bn128_params: ate-pairing Fp does not match alt_bn128_Fq");
+    }
+#endif
 }
 } // libff
@@ -24,6 +24,27 @@ const mp_size_t alt_bn128_q_limbs = (alt_bn128_q_bitcount+GMP_NUMB_BITS-1)/GMP_N
 extern bigint<alt_bn128_r_limbs> alt_bn128_modulus_r;
 extern bigint<alt_bn128_q_limbs> alt_bn128_modulus_q;
 
+#if GMP_NUMB_BITS == 64 && defined(__SIZEOF_INT128__)
+// Montgomery parameters of the moduli at compile time, see fp_constexpr_params
+template<>
+struct fp_constexpr_params<alt_bn128_r_limbs, alt_bn128_modulus_r> {
+    static const bool available = true;
+    static constexpr bigint<alt_bn128_r_limbs> modulus{0x43e1f593f0000001, 0x2833e84879b97091, 0xb85045b68181585d, 0x30644e72e131a029};
+    static constexpr bigint<alt_bn128_r_limbs> Rsquared{0x1bb8e645ae216da7, 0x53fe3ab1e35c59e3, 0x8c49833d53bb8085, 0x0216d0b17f4e44a5};
+    static constexpr bigint<alt_bn128_r_limbs> Rcubed{0x5e94d8e1b4bf0040, 0x2a489cbe1cfbb6b8, 0x893cc664a19fcfed, 0x0cf8594b7fcc657c};
+    static constexpr mp_limb_t inv = 0xc2e1f593efffffff;
+};
+
+template<>
+struct fp_constexpr_params<alt_bn128_q_limbs, alt_bn128_modulus_q> {
+    static const bool available = true;
+    static constexpr bigint<alt_bn128_q_limbs> modulus{0x3c208c16d87cfd47, 0x97816a916871ca8d, 0xb85045b68181585d, 0x30644e72e131a029};
+    static constexpr bigint<alt_bn128_q_limbs> Rsquared{0xf32cfc5b538afa89, 0xb5e71911d44501fb, 0x47ab1eff0a417ff6, 0x06d89f71cab8351f};
+    static constexpr bigint<alt_bn128_q_limbs> Rcubed{0xb1cd6dafda1530df, 0x62f210e6a7283db6, 0xef7f0b0c0ada0afb, 0x20fd6e902d592544};
+    static constexpr mp_limb_t inv = 0x87d20782e4866389;
+};
+#endif
+
 typedef Fp_model<alt_bn128_r_limbs, alt_bn128_modulus_r> alt_bn128_Fr;
 typedef Fp_model<alt_bn128_q_limbs, alt_bn128_modulus_q> alt_bn128_Fq;
 typedef Fp2_model<alt_bn128_q_limbs, alt_bn128_modulus_q> alt_bn128_Fq2;
@@ -41,9 +62,16 @@ extern alt_bn128_Fq alt_bn128_twist_mul_by_b_c1;
 extern alt_bn128_Fq2 alt_bn128_twist_mul_by_q_X;
 extern alt_bn128_Fq2 alt_bn128_twist_mul_by_q_Y;
 
+// constants of the Shallue--van de Woestijne map to E/Fq with Z = 1 (RFC 9380, section 6.6.1)
+extern alt_bn128_Fq alt_bn128_svdw_c1; // g(Z)
+extern alt_bn128_Fq alt_bn128_svdw_c2; // -Z/2
+extern alt_bn128_Fq alt_bn128_svdw_c3; // sqrt(-g(Z) * 3Z^2), even
+extern alt_bn128_Fq alt_bn128_svdw_c4; // -4g(Z) / 3Z^2
+
 // parameters for pairing
 extern bigint<alt_bn128_q_limbs> alt_bn128_ate_loop_count;
 extern bool alt_bn128_ate_is_loop_count_neg;
+extern std::vector<long> alt_bn128_ate_loop_naf; // NAF of alt_bn128_ate_loop_count, least significant digit first
 extern bigint<12*alt_bn128_q_limbs> alt_bn128_final_exponent;
 extern bigint<alt_bn128_q_limbs> alt_bn128_final_exponent_z;
 extern bool alt_bn128_final_exponent_is_z_neg;
@@ -5,13 +5,20 @@
  * @copyright  MIT license (see LICENSE file)
  *****************************************************************************/
 
+#include <algorithm>
 #include <cassert>
+#ifdef MULTICORE
+#include <omp.h>
+#endif
 
 #include <libff/algebra/curves/alt_bn128/alt_bn128_g1.hpp>
 #include <libff/algebra/curves/alt_bn128/alt_bn128_g2.hpp>
 #include <libff/algebra/curves/alt_bn128/alt_bn128_init.hpp>
 #include <libff/algebra/curves/alt_bn128/alt_bn128_pairing.hpp>
 #include <libff/common/profiling.hpp>
+#ifdef ALT_BN128_ATE_PAIRING
+#include "depends/ate-pairing/include/bn.h"
+#endif
 
 namespace libff {
 
@@ -61,6 +68,22 @@ std::istream& operator>>(std::istream &in, alt_bn128_ate_ell_coeffs &c)
     return in;
 }
 
+/*
+  The number of line coefficients of a G2 precomputation, affine or not: one
+  line per doubling and per addition of the NAF loop, and two for the final
+  additions.
+*/
+static size_t alt_bn128_ate_num_coeffs()
+{
+    const std::vector<long> &naf = alt_bn128_ate_loop_naf;
+    size_t result = naf.size() - 1 + 2;
+    for (size_t i = 0; i + 1 < naf.size(); ++i)
+    {
+        result += (naf[i] != 0);
+    }
+    return result;
+}
+
 bool alt_bn128_ate_G2_precomp::operator==(const alt_bn128_ate_G2_precomp &other) const
 {
     return (this->QX == other.QX &&
@@ -70,6 +93,7 @@ bool alt_bn128_ate_G2_precomp::operator==(const alt_bn128_ate_G2_precomp &other)
 
 std::ostream& operator<<(std::ostream& out, const alt_bn128_ate_G2_precomp &prec_Q)
 {
+    out << alt_bn128_ate_G2_precomp::serialization_version << "\n";
     out << prec_Q.QX << OUTPUT_SEPARATOR << prec_Q.QY << "\n";
     out << prec_Q.coeffs.size() << "\n";
     for (const alt_bn128_ate_ell_coeffs &c : prec_Q.coeffs)
@@ -81,6 +105,15 @@ std::ostream& operator<<(std::ostream& out, const alt_bn128_ate_G2_precomp &prec
 
 std::istream& operator>>(std::istream& in, alt_bn128_ate_G2_precomp &prec_Q)
 {
+    unsigned version;
+    in >> version;
+    if (version != alt_bn128_ate_G2_precomp::serialization_version)
+    {
+        in.setstate(std::ios::failbit);
+        return in;
+    }
+    consume_newline(in);
+
     in >> prec_Q.QX;
     consume_OUTPUT_SEPARATOR(in);
     in >> prec_Q.QY;
@@ -89,6 +122,11 @@ std::istream& operator>>(std::istream& in, alt_bn128_ate_G2_precomp &prec_Q)
     prec_Q.coeffs.clear();
     size_t s;
     in >> s;
+    if (s != alt_bn128_ate_num_coeffs())
+    {
+        in.setstate(std::ios::failbit);
+        return in;
+    }
 
     consume_newline(in);
 
@@ -105,6 +143,171 @@ std::istream& operator>>(std::istream& in, alt_bn128_ate_G2_precomp &prec_Q)
     return in;
 }
 
+bool alt_bn128_affine_ate_G1_precomputation::operator==(const alt_bn128_affine_ate_G1_precomputation &other) const
+{
+    return (this->PX == other.PX &&
+            this->PY == other.PY);
+}
+
+std::ostream& operator<<(std::ostream &out, const alt_bn128_affine_ate_G1_precomputation &prec_P)
+{
+    out << prec_P.PX << OUTPUT_SEPARATOR << prec_P.PY;
+
+    return out;
+}
+
+std::istream& operator>>(std::istream &in, alt_bn128_affine_ate_G1_precomputation &prec_P)
+{
+    in >> prec_P.PX;
+    consume_OUTPUT_SEPARATOR(in);
+    in >> prec_P.PY;
+
+    return in;
+}
+
+bool alt_bn128_affine_ate_coeffs::operator==(const alt_bn128_affine_ate_coeffs &other) const
+{
+    return (this->ell_0 == other.ell_0 &&
+            this->gamma == other.gamma);
+}
+
+std::ostream& operator<<(std::ostream &out, const alt_bn128_affine_ate_coeffs &c)
+{
+    out << c.ell_0 << OUTPUT_SEPARATOR << c.gamma;
+    return out;
+}
+
+std::istream& operator>>(std::istream &in, alt_bn128_affine_ate_coeffs &c)
+{
+    in >> c.ell_0;
+    consume_OUTPUT_SEPARATOR(in);
+    in >> c.gamma;
+
+    return in;
+}
+
+bool alt_bn128_affine_ate_G2_precomputation::operator==(const alt_bn128_affine_ate_G2_precomputation &other) const
+{
+    return (this->QX == other.QX &&
+            this->QY == other.QY &&
+            this->coeffs == other.coeffs);
+}
+
+std::ostream& operator<<(std::ostream& out, const alt_bn128_affine_ate_G2_precomputation &prec_Q)
+{
+    out << alt_bn128_affine_ate_G2_precomputation::serialization_version << "\n";
+    out << prec_Q.QX << OUTPUT_SEPARATOR << prec_Q.QY << "\n";
+    out << prec_Q.coeffs.size() << "\n";
+    for (const alt_bn128_affine_ate_coeffs &c : prec_Q.coeffs)
+    {
+        out << c << OUTPUT_NEWLINE;
+    }
+    return out;
+}
+
+std::istream& operator>>(std::istream& in, alt_bn128_affine_ate_G2_precomputation &prec_Q)
+{
+    unsigned version;
+    in >> version;
+    if (version != alt_bn128_affine_ate_G2_precomputation::serialization_version)
+    {
+        in.setstate(std::ios::failbit);
+        return in;
+    }
+    consume_newline(in);
+
+    in >> prec_Q.QX;
+    consume_OUTPUT_SEPARATOR(in);
+    in >> prec_Q.QY;
+    consume_newline(in);
+
+    prec_Q.coeffs.clear();
+    size_t s;
+    in >> s;
+    if (s != alt_bn128_ate_num_coeffs())
+    {
+        in.setstate(std::ios::failbit);
+        return in;
+    }
+
+    consume_newline(in);
+
+    prec_Q.coeffs.reserve(s);
+
+    for (size_t i = 0; i < s; ++i)
+    {
+        alt_bn128_affine_ate_coeffs c;
+        in >> c;
+        consume_OUTPUT_NEWLINE(in);
+        prec_Q.coeffs.emplace_back(c);
+    }
+
+    return in;
+}
+
+#ifdef ALT_BN128_ATE_PAIRING
+/*
+  The ate-pairing library implements the same curve and tower as alt_bn128,
+  and also keeps Fq elements in Montgomery form with R = 2^256, so elements
+  are converted by copying limbs (checked in init_alt_bn128_params).
+*/
+static bn::Fp alt_bn128_to_ate(const alt_bn128_Fq &x)
+{
+    bn::Fp result;
+    for (size_t i = 0; i < alt_bn128_q_limbs; ++i)
+    {
+        result[i] = x.mont_repr.data[i];
+    }
+    return result;
+}
+
+static alt_bn128_Fq alt_bn128_from_ate(const bn::Fp &x)
+{
+    alt_bn128_Fq result;
+    for (size_t i = 0; i < alt_bn128_q_limbs; ++i)
+    {
+        result.mont_repr.data[i] = x[i];
+    }
+    return result;
+}
+
+static bn::Fp2 alt_bn128_to_ate(const alt_bn128_Fq2 &x)
+{
+    return bn::Fp2(alt_bn128_to_ate(x.c0), alt_bn128_to_ate(x.c1));
+}
+
+static alt_bn128_Fq2 alt_bn128_from_ate(const bn::Fp2 &x)
+{
+    return alt_bn128_Fq2(alt_bn128_from_ate(x.a_), alt_bn128_from_ate(x.b_));
+}
+
+static bn::Fp6 alt_bn128_to_ate(const alt_bn128_Fq6 &x)
+{
+    return bn::Fp6(alt_bn128_to_ate(x.c0), alt_bn128_to_ate(x.c1), alt_bn128_to_ate(x.c2));
+}
+
+static alt_bn128_Fq6 alt_bn128_from_ate(const bn::Fp6 &x)
+{
+    return alt_bn128_Fq6(alt_bn128_from_ate(x.a_), alt_bn128_from_ate(x.b_), alt_bn128_from_ate(x.c_));
+}
+
+static bn::Fp12 alt_bn128_to_ate(const alt_bn128_Fq12 &x)
+{
+    return bn::Fp12(alt_bn128_to_ate(x.c0), alt_bn128_to_ate(x.c1));
+}
+
+static alt_bn128_Fq12 alt_bn128_from_ate(const bn::Fp12 &x)
+{
+    return alt_bn128_Fq12(alt_bn128_from_ate(x.a_), alt_bn128_from_ate(x.b_));
+}
+
+/* an evaluated line, in the (a, b, c) = (ell_0, ell_VW, ell_VV) layout of bn::Fp12::Dbl::mul_Fp2_024 */
+static bn::Fp6 alt_bn128_to_ate(const alt_bn128_ate_ell_coeffs &l)
+{
+    return bn::Fp6(alt_bn128_to_ate(l.ell_0), alt_bn128_to_ate(l.ell_VW), alt_bn128_to_ate(l.ell_VV));
+}
+#endif
+
 /* final exponentiations */
 
 alt_bn128_Fq12 alt_bn128_final_exponentiation_first_chunk(const alt_bn128_Fq12 &elt)
@@ -138,7 +341,7 @@ alt_bn128_Fq12 alt_bn128_exp_by_neg_z(const alt_bn128_Fq12 &elt)
 {
     enter_block("Call to alt_bn128_exp_by_neg_z");
 
-    alt_bn128_Fq12 result = elt.cyclotomic_exp(alt_bn128_final_exponent_z);
+    alt_bn128_Fq12 result = elt.cyclotomic_exp_compressed(alt_bn128_final_exponent_z);
     if (!alt_bn128_final_exponent_is_z_neg)
     {
         result = result.unitary_inverse();
@@ -229,13 +432,175 @@ alt_bn128_GT alt_bn128_final_exponentiation(const alt_bn128_Fq12 &elt)
     /* OLD naive version:
         alt_bn128_GT result = elt^alt_bn128_final_exponent;
     */
+#ifdef ALT_BN128_ATE_PAIRING
+    /* same exponent as the two chunks below */
+    bn::Fp12 f = alt_bn128_to_ate(elt);
+    f.final_exp();
+    alt_bn128_GT result = alt_bn128_from_ate(f);
+#else
     alt_bn128_Fq12 A = alt_bn128_final_exponentiation_first_chunk(elt);
     alt_bn128_GT result = alt_bn128_final_exponentiation_last_chunk(A);
+#endif
 
     leave_block("Call to alt_bn128_final_exponentiation");
     return result;
 }
 
+/* exponentiation in GT */
+
+/*
+  Galbraith-Scott decomposition: on GT, Frobenius_map(1) raises to the power
+  q, so elt^k = prod_j Frobenius_map(j)(elt)^(v_j) whenever
+  sum_j v_j * q^j = k (mod r). The rows of B are a basis of the lattice of
+  (v_0, ..., v_3) with sum_j v_j * q^j = 0 (mod r), and rounding k times the
+  first row of B^(-1) (which is g/r) gives |v_j| < 2^65.
+*/
+struct alt_bn128_GT_lattice {
+    mpz_t r;
+    mpz_t g[4];
+    mpz_t B[4][4];
+
+    alt_bn128_GT_lattice()
+    {
+        static const char* g_str[4] = {
+            "49315585627263106345174886791384450966",
+            "1469306990098747947513771323962648467964135393704561048261",
+            "734653495049373973756885661981324233984550527535876948571",
+            "-49315585627263106335243564056998753203"
+        };
+        /* multiples of z, plus constants */
+        static const long B_z[4][4] = { { 1, 1, 1, -2 }, { 2, -1, -1, -1 }, { 2, 2, 2, 2 }, { 1, 4, -2, 1 } };
+        static const long B_1[4][4] = { { 1, 0, 0, 0 }, { 1, 0, -1, 0 }, { 0, 1, 1, 1 }, { -1, 2, 1, -1 } };
+
+        mpz_init(r);
+        alt_bn128_modulus_r.to_mpz(r);
+
+        mpz_t z;
+        mpz_init(z);
+        alt_bn128_final_exponent_z.to_mpz(z);
+        assert(!alt_bn128_final_exponent_is_z_neg);
+
+        for (size_t i = 0; i < 4; ++i)
+        {
+            mpz_init_set_str(g[i], g_str[i], 10);
+            for (size_t j = 0; j < 4; ++j)
+            {
+                mpz_init_set_si(B[i][j], B_1[i][j]);
+                mpz_t t;
+                mpz_init(t);
+                mpz_mul_si(t, z, B_z[i][j]);
+                mpz_add(B[i][j], B[i][j], t);
+                mpz_clear(t);
+            }
+        }
+        mpz_clear(z);
+    }
+
+    ~alt_bn128_GT_lattice()
+    {
+        mpz_clear(r);
+        for (size_t i = 0; i < 4; ++i)
+        {
+            mpz_clear(g[i]);
+            for (size_t j = 0; j < 4; ++j)
+            {
+                mpz_clear(B[i][j]);
+            }
+        }
+    }
+};
+
+/* sum_j (negative[j] ? -1 : 1) * abs_v[j] * q^j = k (mod r) */
+static void alt_bn128_GT_decompose(const alt_bn128_Fr &k, bigint<2> abs_v[4], bool negative[4])
+{
+    static const alt_bn128_GT_lattice L;
+
+    mpz_t k_mpz, alpha, v[4];
+    mpz_init(k_mpz);
+    mpz_init(alpha);
+    k.as_bigint().to_mpz(k_mpz);
+    mpz_init_set(v[0], k_mpz);
+    for (size_t j = 1; j < 4; ++j)
+    {
+        mpz_init(v[j]);
+    }
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        /* alpha = round(k * g_i / r) = floor((2 * k * g_i + r) / (2 * r)) */
+        mpz_mul(alpha, k_mpz, L.g[i]);
+        mpz_mul_2exp(alpha, alpha, 1);
+        mpz_add(alpha, alpha, L.r);
+        mpz_fdiv_q(alpha, alpha, L.r);
+        mpz_fdiv_q_2exp(alpha, alpha, 1);
+
+        for (size_t j = 0; j < 4; ++j)
+        {
+            mpz_submul(v[j], alpha, L.B[i][j]);
+        }
+    }
+
+    for (size_t j = 0; j < 4; ++j)
+    {
+        negative[j] = (mpz_sgn(v[j]) < 0);
+        mpz_abs(v[j], v[j]);
+        abs_v[j] = bigint<2>(v[j]);
+        mpz_clear(v[j]);
+    }
+    mpz_clear(alpha);
+    mpz_clear(k_mpz);
+}
+
+alt_bn128_GT alt_bn128_GT_exp(const alt_bn128_GT &elt, const alt_bn128_Fr &exponent)
+{
+    return alt_bn128_GT_multi_exp(std::vector<alt_bn128_GT>(1, elt), std::vector<alt_bn128_Fr>(1, exponent));
+}
+
+alt_bn128_GT alt_bn128_GT_multi_exp(const std::vector<alt_bn128_GT> &elts,
+                                    const std::vector<alt_bn128_Fr> &exponents)
+{
+    assert(elts.size() == exponents.size());
+
+    /* four exponents of at most 65 bits per element, with shared squarings */
+    std::vector<alt_bn128_GT> bases;
+    std::vector<bigint<2> > abs_v;
+    bases.reserve(4 * elts.size());
+    abs_v.reserve(4 * elts.size());
+    for (size_t i = 0; i < elts.size(); ++i)
+    {
+        bigint<2> v[4];
+        bool negative[4];
+        alt_bn128_GT_decompose(exponents[i], v, negative);
+
+        for (size_t j = 0; j < 4; ++j)
+        {
+            const alt_bn128_GT base = (j == 0 ? elts[i] : elts[i].Frobenius_map(j));
+            bases.emplace_back(negative[j] ? base.unitary_inverse() : base);
+            abs_v.emplace_back(v[j]);
+        }
+    }
+
+    return alt_bn128_Fq12::cyclotomic_multi_exp(bases, abs_v);
+}
+
+bool alt_bn128_GT_is_in_subgroup(const alt_bn128_GT &elt)
+{
+    /* cyclotomic subgroup: elt^(q^4 - q^2 + 1) == 1 */
+    if (elt.is_zero() || elt.Frobenius_map(4) * elt != elt.Frobenius_map(2))
+    {
+        return false;
+    }
+
+    /*
+      Frobenius_map(1) raises to the power q, and (z+1) + z*q + z*q^2 - 2z*q^3
+      is 0 mod r and prime to (q^4 - q^2 + 1)/r. With A = elt^(-z), elt is in
+      GT iff elt * (A^2)^(q^3) == A * A^q * A^(q^2).
+    */
+    const alt_bn128_GT A = alt_bn128_exp_by_neg_z(elt);
+    const alt_bn128_GT A_q = A.Frobenius_map(1);
+    return (elt * A.cyclotomic_squared().Frobenius_map(3) == A * A_q * A_q.Frobenius_map(1));
+}
+
 /* ate pairing */
 
 void doubling_step_for_flipped_miller_loop(const alt_bn128_Fq two_inv,
@@ -287,10 +652,12 @@ void mixed_addition_step_for_flipped_miller_loop(const alt_bn128_G2 base,
     c.ell_VW = D;                                // ell_VW = D (later: * yP    )
 }
 
-alt_bn128_ate_G1_precomp alt_bn128_ate_precompute_G1(const alt_bn128_G1& P)
+/*
+  The precomputations without profiling, which is not thread-safe; these are
+  the ones called from OpenMP parallel regions.
+*/
+static alt_bn128_ate_G1_precomp alt_bn128_ate_precompute_G1_unprofiled(const alt_bn128_G1& P)
 {
-    enter_block("Call to alt_bn128_ate_precompute_G1");
-
     alt_bn128_G1 Pcopy = P;
     Pcopy.to_affine_coordinates();
 
@@ -298,14 +665,11 @@ alt_bn128_ate_G1_precomp alt_bn128_ate_precompute_G1(const alt_bn128_G1& P)
     result.PX = Pcopy.X;
     result.PY = Pcopy.Y;
 
-    leave_block("Call to alt_bn128_ate_precompute_G1");
     return result;
 }
 
-alt_bn128_ate_G2_precomp alt_bn128_ate_precompute_G2(const alt_bn128_G2& Q)
+static alt_bn128_ate_G2_precomp alt_bn128_ate_precompute_G2_unprofiled(const alt_bn128_G2& Q)
 {
-    enter_block("Call to alt_bn128_ate_precompute_G2");
-
     alt_bn128_G2 Qcopy(Q);
     Qcopy.to_affine_coordinates();
 
@@ -320,26 +684,21 @@ alt_bn128_ate_G2_precomp alt_bn128_ate_precompute_G2(const alt_bn128_G2& Q)
     R.Y = Qcopy.Y;
     R.Z = alt_bn128_Fq2::one();
 
-    const bigint<alt_bn128_Fr::num_limbs> &loop_count = alt_bn128_ate_loop_count;
-    bool found_one = false;
+    alt_bn128_G2 Qneg = Qcopy;
+    Qneg.Y = - Qneg.Y;
+
+    const std::vector<long> &naf = alt_bn128_ate_loop_naf;
     alt_bn128_ate_ell_coeffs c;
 
-    for (long i = loop_count.max_bits(); i >= 0; --i)
+    /* NAF digits of alt_bn128_ate_loop_count, except the leading one, in MSB to LSB order */
+    for (long i = naf.size() - 2; i >= 0; --i)
     {
-        const bool bit = loop_count.test_bit(i);
-        if (!found_one)
-        {
-            /* this skips the MSB itself */
-            found_one |= bit;
-            continue;
-        }
-
         doubling_step_for_flipped_miller_loop(two_inv, R, c);
         result.coeffs.push_back(c);
 
-        if (bit)
+        if (naf[i] != 0)
         {
-            mixed_addition_step_for_flipped_miller_loop(Qcopy, R, c);
+            mixed_addition_step_for_flipped_miller_loop(naf[i] > 0 ? Qcopy : Qneg, R, c);
             result.coeffs.push_back(c);
         }
     }
@@ -361,10 +720,98 @@ alt_bn128_ate_G2_precomp alt_bn128_ate_precompute_G2(const alt_bn128_G2& Q)
     mixed_addition_step_for_flipped_miller_loop(Q2, R, c);
     result.coeffs.push_back(c);
 
+    return result;
+}
+
+alt_bn128_ate_G1_precomp alt_bn128_ate_precompute_G1(const alt_bn128_G1& P)
+{
+    enter_block("Call to alt_bn128_ate_precompute_G1");
+    alt_bn128_ate_G1_precomp result = alt_bn128_ate_precompute_G1_unprofiled(P);
+    leave_block("Call to alt_bn128_ate_precompute_G1");
+    return result;
+}
+
+alt_bn128_ate_G2_precomp alt_bn128_ate_precompute_G2(const alt_bn128_G2& Q)
+{
+    enter_block("Call to alt_bn128_ate_precompute_G2");
+    alt_bn128_ate_G2_precomp result = alt_bn128_ate_precompute_G2_unprofiled(Q);
     leave_block("Call to alt_bn128_ate_precompute_G2");
     return result;
 }
 
+/* the line c evaluated at P, in the sparse form taken by mul_by_024 */
+static alt_bn128_ate_ell_coeffs alt_bn128_ate_eval_line(const alt_bn128_ate_ell_coeffs &c,
+                                                        const alt_bn128_ate_G1_precomp &prec_P)
+{
+    alt_bn128_ate_ell_coeffs l;
+    l.ell_0 = c.ell_0;
+    l.ell_VW = prec_P.PY * c.ell_VW;
+    l.ell_VV = prec_P.PX * c.ell_VV;
+    return l;
+}
+
+/*
+  The Miller loops only touch f through the three functions below; with
+  ALT_BN128_ATE_PAIRING they run on the JIT-compiled ate-pairing library.
+*/
+
+/* f^2 */
+static alt_bn128_Fq12 alt_bn128_ate_square(const alt_bn128_Fq12 &f)
+{
+#ifdef ALT_BN128_ATE_PAIRING
+    bn::Fp12 result = alt_bn128_to_ate(f);
+    bn::Fp12::square(result);
+    return alt_bn128_from_ate(result);
+#else
+    return f.squared();
+#endif
+}
+
+/* f * l for an evaluated line l */
+static alt_bn128_Fq12 alt_bn128_ate_mul_by_line(const alt_bn128_Fq12 &f,
+                                                const alt_bn128_ate_ell_coeffs &l)
+{
+#ifdef ALT_BN128_ATE_PAIRING
+    bn::Fp12 result = alt_bn128_to_ate(f);
+    bn::Fp12::Dbl::mul_Fp2_024(result, alt_bn128_to_ate(l));
+    return alt_bn128_from_ate(result);
+#else
+    return f.mul_by_024(l.ell_0, l.ell_VW, l.ell_VV);
+#endif
+}
+
+/* f * l1 * l2 for evaluated lines l1, l2; cheaper than two mul_by_024 */
+static alt_bn128_Fq12 alt_bn128_ate_mul_by_two_lines(const alt_bn128_Fq12 &f,
+                                                     const alt_bn128_ate_ell_coeffs &l1,
+                                                     const alt_bn128_ate_ell_coeffs &l2)
+{
+#ifdef ALT_BN128_ATE_PAIRING
+    bn::Fp12 l1l2, result;
+    bn::Fp12::Dbl::mul_Fp2_024_Fp2_024(l1l2, alt_bn128_to_ate(l1), alt_bn128_to_ate(l2));
+    bn::Fp12::mul(result, alt_bn128_to_ate(f), l1l2);
+    return alt_bn128_from_ate(result);
+#else
+    return f * alt_bn128_Fq12::mul_024_by_024(l1.ell_0, l1.ell_VW, l1.ell_VV,
+                                              l2.ell_0, l2.ell_VW, l2.ell_VV);
+#endif
+}
+
+/* f * (product of the evaluated lines), two at a time */
+static alt_bn128_Fq12 alt_bn128_ate_mul_by_lines(alt_bn128_Fq12 f,
+                                                 const std::vector<alt_bn128_ate_ell_coeffs> &lines)
+{
+    size_t j = 0;
+    for (; j + 1 < lines.size(); j += 2)
+    {
+        f = alt_bn128_ate_mul_by_two_lines(f, lines[j], lines[j+1]);
+    }
+    if (j < lines.size())
+    {
+        f = alt_bn128_ate_mul_by_line(f, lines[j]);
+    }
+    return f;
+}
+
 alt_bn128_Fq12 alt_bn128_ate_miller_loop(const alt_bn128_ate_G1_precomp &prec_P,
                                      const alt_bn128_ate_G2_precomp &prec_Q)
 {
@@ -372,36 +819,28 @@ alt_bn128_Fq12 alt_bn128_ate_miller_loop(const alt_bn128_ate_G1_precomp &prec_P,
 
     alt_bn128_Fq12 f = alt_bn128_Fq12::one();
 
-    bool found_one = false;
     size_t idx = 0;
 
-    const bigint<alt_bn128_Fr::num_limbs> &loop_count = alt_bn128_ate_loop_count;
-    alt_bn128_ate_ell_coeffs c;
+    const std::vector<long> &naf = alt_bn128_ate_loop_naf;
+    alt_bn128_ate_ell_coeffs l1, l2;
 
-    for (long i = loop_count.max_bits(); i >= 0; --i)
+    for (long i = naf.size() - 2; i >= 0; --i)
     {
-        const bool bit = loop_count.test_bit(i);
-        if (!found_one)
-        {
-            /* this skips the MSB itself */
-            found_one |= bit;
-            continue;
-        }
-
-        /* code below gets executed for all bits (EXCEPT the MSB itself) of
-           alt_bn128_param_p (skipping leading zeros) in MSB to LSB
-           order */
+        /* code below gets executed for all NAF digits (EXCEPT the leading
+           one) of alt_bn128_ate_loop_count in MSB to LSB order */
 
-        c = prec_Q.coeffs[idx++];
-        f = f.squared();
-        f = f.mul_by_024(c.ell_0, prec_P.PY * c.ell_VW, prec_P.PX * c.ell_VV);
+        l1 = alt_bn128_ate_eval_line(prec_Q.coeffs[idx++], prec_P);
+        f = alt_bn128_ate_square(f);
 
-        if (bit)
+        if (naf[i] != 0)
         {
-            c = prec_Q.coeffs[idx++];
-            f = f.mul_by_024(c.ell_0, prec_P.PY * c.ell_VW, prec_P.PX * c.ell_VV);
+            l2 = alt_bn128_ate_eval_line(prec_Q.coeffs[idx++], prec_P);
+            f = alt_bn128_ate_mul_by_two_lines(f, l1, l2);
+        }
+        else
+        {
+            f = alt_bn128_ate_mul_by_line(f, l1);
         }
-
     }
 
     if (alt_bn128_ate_is_loop_count_neg)
@@ -409,11 +848,9 @@ alt_bn128_Fq12 alt_bn128_ate_miller_loop(const alt_bn128_ate_G1_precomp &prec_P,
     	f = f.inverse();
     }
 
-    c = prec_Q.coeffs[idx++];
-    f = f.mul_by_024(c.ell_0,prec_P.PY * c.ell_VW,prec_P.PX * c.ell_VV);
-
-    c = prec_Q.coeffs[idx++];
-    f = f.mul_by_024(c.ell_0,prec_P.PY * c.ell_VW,prec_P.PX * c.ell_VV);
+    l1 = alt_bn128_ate_eval_line(prec_Q.coeffs[idx++], prec_P);
+    l2 = alt_bn128_ate_eval_line(prec_Q.coeffs[idx++], prec_P);
+    f = alt_bn128_ate_mul_by_two_lines(f, l1, l2);
 
     leave_block("Call to alt_bn128_ate_miller_loop");
     return f;
@@ -428,62 +865,135 @@ alt_bn128_Fq12 alt_bn128_ate_double_miller_loop(const alt_bn128_ate_G1_precomp &
 
     alt_bn128_Fq12 f = alt_bn128_Fq12::one();
 
-    bool found_one = false;
     size_t idx = 0;
 
-    const bigint<alt_bn128_Fr::num_limbs> &loop_count = alt_bn128_ate_loop_count;
-    for (long i = loop_count.max_bits(); i >= 0; --i)
+    const std::vector<long> &naf = alt_bn128_ate_loop_naf;
+    for (long i = naf.size() - 2; i >= 0; --i)
     {
-        const bool bit = loop_count.test_bit(i);
-        if (!found_one)
+        /* code below gets executed for all NAF digits (EXCEPT the leading
+           one) of alt_bn128_ate_loop_count in MSB to LSB order */
+
+        alt_bn128_ate_ell_coeffs l1 = alt_bn128_ate_eval_line(prec_Q1.coeffs[idx], prec_P1);
+        alt_bn128_ate_ell_coeffs l2 = alt_bn128_ate_eval_line(prec_Q2.coeffs[idx], prec_P2);
+        ++idx;
+
+        f = alt_bn128_ate_square(f);
+        f = alt_bn128_ate_mul_by_two_lines(f, l1, l2);
+
+        if (naf[i] != 0)
         {
-            /* this skips the MSB itself */
-            found_one |= bit;
-            continue;
+            l1 = alt_bn128_ate_eval_line(prec_Q1.coeffs[idx], prec_P1);
+            l2 = alt_bn128_ate_eval_line(prec_Q2.coeffs[idx], prec_P2);
+            ++idx;
+
+            f = alt_bn128_ate_mul_by_two_lines(f, l1, l2);
         }
+    }
 
-        /* code below gets executed for all bits (EXCEPT the MSB itself) of
-           alt_bn128_param_p (skipping leading zeros) in MSB to LSB
-           order */
+    if (alt_bn128_ate_is_loop_count_neg)
+    {
+    	f = f.inverse();
+    }
 
-        alt_bn128_ate_ell_coeffs c1 = prec_Q1.coeffs[idx];
-        alt_bn128_ate_ell_coeffs c2 = prec_Q2.coeffs[idx];
+    for (size_t k = 0; k < 2; ++k)
+    {
+        const alt_bn128_ate_ell_coeffs l1 = alt_bn128_ate_eval_line(prec_Q1.coeffs[idx], prec_P1);
+        const alt_bn128_ate_ell_coeffs l2 = alt_bn128_ate_eval_line(prec_Q2.coeffs[idx], prec_P2);
         ++idx;
+        f = alt_bn128_ate_mul_by_two_lines(f, l1, l2);
+    }
 
-        f = f.squared();
+    leave_block("Call to alt_bn128_ate_double_miller_loop");
 
-        f = f.mul_by_024(c1.ell_0, prec_P1.PY * c1.ell_VW, prec_P1.PX * c1.ell_VV);
-        f = f.mul_by_024(c2.ell_0, prec_P2.PY * c2.ell_VW, prec_P2.PX * c2.ell_VV);
+    return f;
+}
 
-        if (bit)
-        {
-            alt_bn128_ate_ell_coeffs c1 = prec_Q1.coeffs[idx];
-            alt_bn128_ate_ell_coeffs c2 = prec_Q2.coeffs[idx];
-            ++idx;
+/* Miller loop over the pairs begin, ..., end-1 of prec_P and prec_Q */
+static alt_bn128_Fq12 alt_bn128_ate_partial_miller_loop(const std::vector<alt_bn128_ate_G1_precomp> &prec_P,
+                                                        const std::vector<alt_bn128_ate_G2_precomp> &prec_Q,
+                                                        const size_t begin,
+                                                        const size_t end)
+{
+    alt_bn128_Fq12 f = alt_bn128_Fq12::one();
 
-            f = f.mul_by_024(c1.ell_0, prec_P1.PY * c1.ell_VW, prec_P1.PX * c1.ell_VV);
-            f = f.mul_by_024(c2.ell_0, prec_P2.PY * c2.ell_VW, prec_P2.PX * c2.ell_VV);
+    size_t idx = 0;
+    std::vector<alt_bn128_ate_ell_coeffs> lines;
+    lines.reserve(2 * (end - begin));
+
+    const std::vector<long> &naf = alt_bn128_ate_loop_naf;
+    for (long i = naf.size() - 2; i >= 0; --i)
+    {
+        /* code below gets executed for all NAF digits (EXCEPT the leading
+           one) of alt_bn128_ate_loop_count in MSB to LSB order; the
+           squaring of f is shared by all pairs */
+        f = alt_bn128_ate_square(f);
+
+        lines.clear();
+        for (size_t j = begin; j < end; ++j)
+        {
+            lines.emplace_back(alt_bn128_ate_eval_line(prec_Q[j].coeffs[idx], prec_P[j]));
+            if (naf[i] != 0)
+            {
+                lines.emplace_back(alt_bn128_ate_eval_line(prec_Q[j].coeffs[idx+1], prec_P[j]));
+            }
         }
+        idx += (naf[i] != 0 ? 2 : 1);
+
+        f = alt_bn128_ate_mul_by_lines(f, lines);
     }
 
     if (alt_bn128_ate_is_loop_count_neg)
     {
-    	f = f.inverse();
+        f = f.inverse();
     }
 
-    alt_bn128_ate_ell_coeffs c1 = prec_Q1.coeffs[idx];
-    alt_bn128_ate_ell_coeffs c2 = prec_Q2.coeffs[idx];
-    ++idx;
-    f = f.mul_by_024(c1.ell_0, prec_P1.PY * c1.ell_VW, prec_P1.PX * c1.ell_VV);
-    f = f.mul_by_024(c2.ell_0, prec_P2.PY * c2.ell_VW, prec_P2.PX * c2.ell_VV);
+    /* the two final additions, with Frobenius images of Q */
+    lines.clear();
+    for (size_t j = begin; j < end; ++j)
+    {
+        lines.emplace_back(alt_bn128_ate_eval_line(prec_Q[j].coeffs[idx], prec_P[j]));
+        lines.emplace_back(alt_bn128_ate_eval_line(prec_Q[j].coeffs[idx+1], prec_P[j]));
+    }
+    f = alt_bn128_ate_mul_by_lines(f, lines);
 
-    c1 = prec_Q1.coeffs[idx];
-    c2 = prec_Q2.coeffs[idx];
-    ++idx;
-    f = f.mul_by_024(c1.ell_0, prec_P1.PY * c1.ell_VW, prec_P1.PX * c1.ell_VV);
-    f = f.mul_by_024(c2.ell_0, prec_P2.PY * c2.ell_VW, prec_P2.PX * c2.ell_VV);
+    return f;
+}
 
-    leave_block("Call to alt_bn128_ate_double_miller_loop");
+alt_bn128_Fq12 alt_bn128_ate_multi_miller_loop(const std::vector<alt_bn128_ate_G1_precomp> &prec_P,
+                                              const std::vector<alt_bn128_ate_G2_precomp> &prec_Q)
+{
+    enter_block("Call to alt_bn128_ate_multi_miller_loop");
+    assert(prec_P.size() == prec_Q.size());
+
+    const size_t num_pairs = prec_P.size();
+    alt_bn128_Fq12 f;
+#ifdef MULTICORE
+    /* one partial product per thread, each with its own squarings */
+    const size_t num_chunks = std::min<size_t>(omp_get_max_threads(), num_pairs);
+    if (num_chunks > 1)
+    {
+        std::vector<alt_bn128_Fq12> partial(num_chunks);
+#pragma omp parallel for
+        for (size_t i = 0; i < num_chunks; ++i)
+        {
+            partial[i] = alt_bn128_ate_partial_miller_loop(prec_P, prec_Q,
+                                                           i * num_pairs / num_chunks,
+                                                           (i + 1) * num_pairs / num_chunks);
+        }
+
+        f = partial[0];
+        for (size_t i = 1; i < num_chunks; ++i)
+        {
+            f = f * partial[i];
+        }
+    }
+    else
+#endif
+    {
+        f = alt_bn128_ate_partial_miller_loop(prec_P, prec_Q, 0, num_pairs);
+    }
+
+    leave_block("Call to alt_bn128_ate_multi_miller_loop");
 
     return f;
 }
@@ -507,6 +1017,226 @@ alt_bn128_GT alt_bn128_ate_reduced_pairing(const alt_bn128_G1 &P, const alt_bn12
     return result;
 }
 
+alt_bn128_GT alt_bn128_ate_multi_reduced_pairing(const std::vector<alt_bn128_G1> &P, const std::vector<alt_bn128_G2> &Q)
+{
+    enter_block("Call to alt_bn128_ate_multi_reduced_pairing");
+    assert(P.size() == Q.size());
+
+    enter_block("Precompute pairs");
+    std::vector<alt_bn128_ate_G1_precomp> prec_P(P.size());
+    std::vector<alt_bn128_ate_G2_precomp> prec_Q(Q.size());
+#ifdef MULTICORE
+#pragma omp parallel for
+#endif
+    for (size_t i = 0; i < P.size(); ++i)
+    {
+        prec_P[i] = alt_bn128_ate_precompute_G1_unprofiled(P[i]);
+        prec_Q[i] = alt_bn128_ate_precompute_G2_unprofiled(Q[i]);
+    }
+    leave_block("Precompute pairs");
+
+    const alt_bn128_Fq12 f = alt_bn128_ate_multi_miller_loop(prec_P, prec_Q);
+    const alt_bn128_GT result = alt_bn128_final_exponentiation(f);
+    leave_block("Call to alt_bn128_ate_multi_reduced_pairing");
+    return result;
+}
+
+/* affine ate miller loop */
+
+alt_bn128_affine_ate_G1_precomputation alt_bn128_affine_ate_precompute_G1(const alt_bn128_G1& P)
+{
+    enter_block("Call to alt_bn128_affine_ate_precompute_G1");
+
+    alt_bn128_G1 Pcopy = P;
+    Pcopy.to_affine_coordinates();
+
+    alt_bn128_affine_ate_G1_precomputation result;
+    result.PX = Pcopy.X;
+    result.PY = Pcopy.Y;
+
+    leave_block("Call to alt_bn128_affine_ate_precompute_G1");
+    return result;
+}
+
+/* tangent line at R, and R <- 2R */
+static alt_bn128_affine_ate_coeffs alt_bn128_affine_ate_doubling_step(alt_bn128_Fq2 &RX, alt_bn128_Fq2 &RY)
+{
+    alt_bn128_affine_ate_coeffs c;
+    const alt_bn128_Fq2 RX_2 = RX.squared();
+    c.gamma = (RX_2 + RX_2 + RX_2) * (RY + RY).inverse(); // gamma = 3 * RX^2 / (2 * RY)
+    c.ell_0 = alt_bn128_twist * (c.gamma * RX - RY);      // ell_0 = xi * (gamma * RX - RY)
+
+    const alt_bn128_Fq2 new_RX = c.gamma.squared() - (RX + RX);
+    RY = c.gamma * (RX - new_RX) - RY;
+    RX = new_RX;
+    return c;
+}
+
+/* line through R and (x2, y2), and R <- R + (x2, y2) */
+static alt_bn128_affine_ate_coeffs alt_bn128_affine_ate_addition_step(const alt_bn128_Fq2 &x2, const alt_bn128_Fq2 &y2,
+                                                                      alt_bn128_Fq2 &RX, alt_bn128_Fq2 &RY)
+{
+    alt_bn128_affine_ate_coeffs c;
+    c.gamma = (RY - y2) * (RX - x2).inverse();       // gamma = (RY - y2) / (RX - x2)
+    c.ell_0 = alt_bn128_twist * (c.gamma * x2 - y2); // ell_0 = xi * (gamma * x2 - y2)
+
+    const alt_bn128_Fq2 new_RX = c.gamma.squared() - (RX + x2);
+    RY = c.gamma * (RX - new_RX) - RY;
+    RX = new_RX;
+    return c;
+}
+
+alt_bn128_affine_ate_G2_precomputation alt_bn128_affine_ate_precompute_G2(const alt_bn128_G2& Q)
+{
+    enter_block("Call to alt_bn128_affine_ate_precompute_G2");
+
+    alt_bn128_G2 Qcopy(Q);
+    Qcopy.to_affine_coordinates();
+
+    alt_bn128_affine_ate_G2_precomputation result;
+    result.QX = Qcopy.X;
+    result.QY = Qcopy.Y;
+    result.coeffs.reserve(alt_bn128_ate_num_coeffs());
+
+    alt_bn128_Fq2 RX = Qcopy.X;
+    alt_bn128_Fq2 RY = Qcopy.Y;
+
+    /* same schedule as alt_bn128_ate_precompute_G2, with R kept in affine coordinates */
+    const std::vector<long> &naf = alt_bn128_ate_loop_naf;
+    for (long i = naf.size() - 2; i >= 0; --i)
+    {
+        result.coeffs.emplace_back(alt_bn128_affine_ate_doubling_step(RX, RY));
+
+        if (naf[i] != 0)
+        {
+            result.coeffs.emplace_back(alt_bn128_affine_ate_addition_step(Qcopy.X, naf[i] > 0 ? Qcopy.Y : -Qcopy.Y, RX, RY));
+        }
+    }
+
+    alt_bn128_G2 Q1 = Qcopy.mul_by_q();
+    assert(Q1.Z == alt_bn128_Fq2::one());
+    alt_bn128_G2 Q2 = Q1.mul_by_q();
+    assert(Q2.Z == alt_bn128_Fq2::one());
+
+    if (alt_bn128_ate_is_loop_count_neg)
+    {
+        RY = - RY;
+    }
+
+    result.coeffs.emplace_back(alt_bn128_affine_ate_addition_step(Q1.X, Q1.Y, RX, RY));
+    result.coeffs.emplace_back(alt_bn128_affine_ate_addition_step(Q2.X, -Q2.Y, RX, RY));
+
+    leave_block("Call to alt_bn128_affine_ate_precompute_G2");
+    return result;
+}
+
+/* the line c evaluated at P, in the sparse form taken by mul_by_024 */
+static alt_bn128_ate_ell_coeffs alt_bn128_affine_ate_eval_line(const alt_bn128_affine_ate_coeffs &c,
+                                                               const alt_bn128_affine_ate_G1_precomputation &prec_P)
+{
+    alt_bn128_ate_ell_coeffs l;
+    l.ell_0 = c.ell_0;
+    l.ell_VW = alt_bn128_Fq2(prec_P.PY, alt_bn128_Fq::zero());
+    l.ell_VV = - (prec_P.PX * c.gamma);
+    return l;
+}
+
+alt_bn128_Fq12 alt_bn128_affine_ate_miller_loop(const alt_bn128_affine_ate_G1_precomputation &prec_P,
+                                                const alt_bn128_affine_ate_G2_precomputation &prec_Q)
+{
+    enter_block("Call to alt_bn128_affine_ate_miller_loop");
+
+    alt_bn128_Fq12 f = alt_bn128_Fq12::one();
+
+    size_t idx = 0;
+
+    const std::vector<long> &naf = alt_bn128_ate_loop_naf;
+    alt_bn128_ate_ell_coeffs l1, l2;
+
+    for (long i = naf.size() - 2; i >= 0; --i)
+    {
+        /* code below gets executed for all NAF digits (EXCEPT the leading
+           one) of alt_bn128_ate_loop_count in MSB to LSB order */
+
+        l1 = alt_bn128_affine_ate_eval_line(prec_Q.coeffs[idx++], prec_P);
+        f = alt_bn128_ate_square(f);
+
+        if (naf[i] != 0)
+        {
+            l2 = alt_bn128_affine_ate_eval_line(prec_Q.coeffs[idx++], prec_P);
+            f = alt_bn128_ate_mul_by_two_lines(f, l1, l2);
+        }
+        else
+        {
+            f = alt_bn128_ate_mul_by_line(f, l1);
+        }
+    }
+
+    if (alt_bn128_ate_is_loop_count_neg)
+    {
+        f = f.inverse();
+    }
+
+    l1 = alt_bn128_affine_ate_eval_line(prec_Q.coeffs[idx++], prec_P);
+    l2 = alt_bn128_affine_ate_eval_line(prec_Q.coeffs[idx++], prec_P);
+    f = alt_bn128_ate_mul_by_two_lines(f, l1, l2);
+
+    leave_block("Call to alt_bn128_affine_ate_miller_loop");
+    return f;
+}
+
+alt_bn128_Fq12 alt_bn128_affine_ate_double_miller_loop(const alt_bn128_affine_ate_G1_precomputation &prec_P1,
+                                                       const alt_bn128_affine_ate_G2_precomputation &prec_Q1,
+                                                       const alt_bn128_affine_ate_G1_precomputation &prec_P2,
+                                                       const alt_bn128_affine_ate_G2_precomputation &prec_Q2)
+{
+    enter_block("Call to alt_bn128_affine_ate_double_miller_loop");
+
+    alt_bn128_Fq12 f = alt_bn128_Fq12::one();
+
+    size_t idx = 0;
+
+    const std::vector<long> &naf = alt_bn128_ate_loop_naf;
+    for (long i = naf.size() - 2; i >= 0; --i)
+    {
+        /* code below gets executed for all NAF digits (EXCEPT the leading
+           one) of alt_bn128_ate_loop_count in MSB to LSB order */
+
+        alt_bn128_ate_ell_coeffs l1 = alt_bn128_affine_ate_eval_line(prec_Q1.coeffs[idx], prec_P1);
+        alt_bn128_ate_ell_coeffs l2 = alt_bn128_affine_ate_eval_line(prec_Q2.coeffs[idx], prec_P2);
+        ++idx;
+
+        f = alt_bn128_ate_square(f);
+        f = alt_bn128_ate_mul_by_two_lines(f, l1, l2);
+
+        if (naf[i] != 0)
+        {
+            l1 = alt_bn128_affine_ate_eval_line(prec_Q1.coeffs[idx], prec_P1);
+            l2 = alt_bn128_affine_ate_eval_line(prec_Q2.coeffs[idx], prec_P2);
+            ++idx;
+
+            f = alt_bn128_ate_mul_by_two_lines(f, l1, l2);
+        }
+    }
+
+    if (alt_bn128_ate_is_loop_count_neg)
+    {
+        f = f.inverse();
+    }
+
+    for (size_t k = 0; k < 2; ++k)
+    {
+        const alt_bn128_ate_ell_coeffs l1 = alt_bn128_affine_ate_eval_line(prec_Q1.coeffs[idx], prec_P1);
+        const alt_bn128_ate_ell_coeffs l2 = alt_bn128_affine_ate_eval_line(prec_Q2.coeffs[idx], prec_P2);
+        ++idx;
+        f = alt_bn128_ate_mul_by_two_lines(f, l1, l2);
+    }
+
+    leave_block("Call to alt_bn128_affine_ate_double_miller_loop");
+
+    return f;
+}
+
 /* choice of pairing */
 
 alt_bn128_G1_precomp alt_bn128_precompute_G1(const alt_bn128_G1& P)
@@ -533,6 +1263,12 @@ alt_bn128_Fq12 alt_bn128_double_miller_loop(const alt_bn128_G1_precomp &prec_P1,
     return alt_bn128_ate_double_miller_loop(prec_P1, prec_Q1, prec_P2, prec_Q2);
 }
 
+alt_bn128_Fq12 alt_bn128_multi_miller_loop(const std::vector<alt_bn128_G1_precomp> &prec_P,
+                                           const std::vector<alt_bn128_G2_precomp> &prec_Q)
+{
+    return alt_bn128_ate_multi_miller_loop(prec_P, prec_Q);
+}
+
 alt_bn128_Fq12 alt_bn128_pairing(const alt_bn128_G1& P,
                       const alt_bn128_G2 &Q)
 {
@@ -544,4 +1280,20 @@ alt_bn128_GT alt_bn128_reduced_pairing(const alt_bn128_G1 &P,
 {
     return alt_bn128_ate_reduced_pairing(P, Q);
 }
+
+alt_bn128_GT alt_bn128_multi_reduced_pairing(const std::vector<alt_bn128_G1> &P,
+                                             const std::vector<alt_bn128_G2> &Q)
+{
+    return alt_bn128_ate_multi_reduced_pairing(P, Q);
+}
+
+alt_bn128_GT alt_bn128_affine_reduced_pairing(const alt_bn128_G1 &P,
+                                              const alt_bn128_G2 &Q)
+{
+    const alt_bn128_affine_ate_G1_precomputation prec_P = alt_bn128_affine_ate_precompute_G1(P);
+    const alt_bn128_affine_ate_G2_precomputation prec_Q = alt_bn128_affine_ate_precompute_G2(Q);
+    const alt_bn128_Fq12 f = alt_bn128_affine_ate_miller_loop(prec_P, prec_Q);
+    const alt_bn128_GT result = alt_bn128_final_exponentiation(f);
+    return result;
+}
 } // libff
@@ -17,6 +17,15 @@ namespace libff {
 
 alt_bn128_GT alt_bn128_final_exponentiation(const alt_bn128_Fq12 &elt);
 
+/* exponentiation in GT; elt must have order r, e.g. be a reduced pairing */
+
+alt_bn128_GT alt_bn128_GT_exp(const alt_bn128_GT &elt, const alt_bn128_Fr &exponent);
+alt_bn128_GT alt_bn128_GT_multi_exp(const std::vector<alt_bn128_GT> &elts,
+                                    const std::vector<alt_bn128_Fr> &exponents);
+
+/* whether elt is in GT, the subgroup of order r of alt_bn128_Fq12^* */
+bool alt_bn128_GT_is_in_subgroup(const alt_bn128_GT &elt);
+
 /* ate pairing */
 
 struct alt_bn128_ate_G1_precomp {
@@ -39,6 +48,9 @@ struct alt_bn128_ate_ell_coeffs {
 };
 
 struct alt_bn128_ate_G2_precomp {
+    /* bumped whenever the serialized layout below, or the loop the coeffs follow, changes */
+    static const unsigned serialization_version = 1;
+
     alt_bn128_Fq2 QX;
     alt_bn128_Fq2 QY;
     std::vector<alt_bn128_ate_ell_coeffs> coeffs;
@@ -57,11 +69,64 @@ alt_bn128_Fq12 alt_bn128_ate_double_miller_loop(const alt_bn128_ate_G1_precomp &
                                      const alt_bn128_ate_G2_precomp &prec_Q1,
                                      const alt_bn128_ate_G1_precomp &prec_P2,
                                      const alt_bn128_ate_G2_precomp &prec_Q2);
+alt_bn128_Fq12 alt_bn128_ate_multi_miller_loop(const std::vector<alt_bn128_ate_G1_precomp> &prec_P,
+                                               const std::vector<alt_bn128_ate_G2_precomp> &prec_Q);
 
 alt_bn128_Fq12 alt_bn128_ate_pairing(const alt_bn128_G1& P,
                           const alt_bn128_G2 &Q);
 alt_bn128_GT alt_bn128_ate_reduced_pairing(const alt_bn128_G1 &P,
                                  const alt_bn128_G2 &Q);
+alt_bn128_GT alt_bn128_ate_multi_reduced_pairing(const std::vector<alt_bn128_G1> &P,
+                                                 const std::vector<alt_bn128_G2> &Q);
+
+/* affine ate miller loop */
+
+struct alt_bn128_affine_ate_G1_precomputation {
+    alt_bn128_Fq PX;
+    alt_bn128_Fq PY;
+
+    bool operator==(const alt_bn128_affine_ate_G1_precomputation &other) const;
+    friend std::ostream& operator<<(std::ostream &out, const alt_bn128_affine_ate_G1_precomputation &prec_P);
+    friend std::istream& operator>>(std::istream &in, alt_bn128_affine_ate_G1_precomputation &prec_P);
+};
+
+/*
+  Line through R with slope gamma, normalized so that its yP coefficient is
+  one: it evaluates at P to ell_0 + PY * vw - gamma * PX * v^2, with
+  ell_0 = xi * (gamma * RX - RY).
+*/
+struct alt_bn128_affine_ate_coeffs {
+    alt_bn128_Fq2 ell_0;
+    alt_bn128_Fq2 gamma;
+
+    bool operator==(const alt_bn128_affine_ate_coeffs &other) const;
+    friend std::ostream& operator<<(std::ostream &out, const alt_bn128_affine_ate_coeffs &c);
+    friend std::istream& operator>>(std::istream &in, alt_bn128_affine_ate_coeffs &c);
+};
+
+struct alt_bn128_affine_ate_G2_precomputation {
+    /* bumped whenever the serialized layout below changes */
+    static const unsigned serialization_version = 1;
+
+    alt_bn128_Fq2 QX;
+    alt_bn128_Fq2 QY;
+    std::vector<alt_bn128_affine_ate_coeffs> coeffs;
+
+    bool operator==(const alt_bn128_affine_ate_G2_precomputation &other) const;
+    friend std::ostream& operator<<(std::ostream &out, const alt_bn128_affine_ate_G2_precomputation &prec_Q);
+    /* sets failbit on in for an unknown version or a wrong number of coefficients */
+    friend std::istream& operator>>(std::istream &in, alt_bn128_affine_ate_G2_precomputation &prec_Q);
+};
+
+alt_bn128_affine_ate_G1_precomputation alt_bn128_affine_ate_precompute_G1(const alt_bn128_G1& P);
+alt_bn128_affine_ate_G2_precomputation alt_bn128_affine_ate_precompute_G2(const alt_bn128_G2& Q);
+
+alt_bn128_Fq12 alt_bn128_affine_ate_miller_loop(const alt_bn128_affine_ate_G1_precomputation &prec_P,
+                                                const alt_bn128_affine_ate_G2_precomputation &prec_Q);
+alt_bn128_Fq12 alt_bn128_affine_ate_double_miller_loop(const alt_bn128_affine_ate_G1_precomputation &prec_P1,
+                                                       const alt_bn128_affine_ate_G2_precomputation &prec_Q1,
+                                                       const alt_bn128_affine_ate_G1_precomputation &prec_P2,
+                                                       const alt_bn128_affine_ate_G2_precomputation &prec_Q2);
 
 /* choice of pairing */
 
@@ -80,12 +145,19 @@ alt_bn128_Fq12 alt_bn128_double_miller_loop(const alt_bn128_G1_precomp &prec_P1,
                                  const alt_bn128_G1_precomp &prec_P2,
                                  const alt_bn128_G2_precomp &prec_Q2);
 
+alt_bn128_Fq12 alt_bn128_multi_miller_loop(const std::vector<alt_bn128_G1_precomp> &prec_P,
+                                           const std::vector<alt_bn128_G2_precomp> &prec_Q);
+
 alt_bn128_Fq12 alt_bn128_pairing(const alt_bn128_G1& P,
                       const alt_bn128_G2 &Q);
 
 alt_bn128_GT alt_bn128_reduced_pairing(const alt_bn128_G1 &P,
                              const alt_bn128_G2 &Q);
 
+/* product of the reduced pairings of (P[i], Q[i]), with one final exponentiation */
+alt_bn128_GT alt_bn128_multi_reduced_pairing(const std::vector<alt_bn128_G1> &P,
+                                             const std::vector<alt_bn128_G2> &Q);
+
 alt_bn128_GT alt_bn128_affine_reduced_pairing(const alt_bn128_G1 &P,
                                     const alt_bn128_G2 &Q);
 
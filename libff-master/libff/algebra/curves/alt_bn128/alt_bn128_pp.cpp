@@ -6,6 +6,7 @@
  *****************************************************************************/
 
 #include <libff/algebra/curves/alt_bn128/alt_bn128_pp.hpp>
+#include <libff/common/profiling.hpp>
 
 namespace libff {
 
@@ -35,6 +36,49 @@ alt_bn128_Fq12 alt_bn128_pp::miller_loop(const alt_bn128_G1_precomp &prec_P,
     return alt_bn128_miller_loop(prec_P, prec_Q);
 }
 
+alt_bn128_affine_ate_G1_precomputation alt_bn128_pp::affine_ate_precompute_G1(const alt_bn128_G1 &P)
+{
+    return alt_bn128_affine_ate_precompute_G1(P);
+}
+
+alt_bn128_affine_ate_G2_precomputation alt_bn128_pp::affine_ate_precompute_G2(const alt_bn128_G2 &Q)
+{
+    return alt_bn128_affine_ate_precompute_G2(Q);
+}
+
+alt_bn128_Fq12 alt_bn128_pp::affine_ate_miller_loop(const alt_bn128_affine_ate_G1_precomputation &prec_P,
+                                                    const alt_bn128_affine_ate_G2_precomputation &prec_Q)
+{
+    return alt_bn128_affine_ate_miller_loop(prec_P, prec_Q);
+}
+
+/* dividing by e(P, Q) is the same as multiplying by e(-P, Q) */
+static alt_bn128_affine_ate_G1_precomputation alt_bn128_affine_ate_negate_G1(const alt_bn128_affine_ate_G1_precomputation &prec_P)
+{
+    alt_bn128_affine_ate_G1_precomputation result = prec_P;
+    result.PY = -result.PY;
+    return result;
+}
+
+alt_bn128_Fq12 alt_bn128_pp::affine_ate_e_over_e_miller_loop(const alt_bn128_affine_ate_G1_precomputation &prec_P1,
+                                                             const alt_bn128_affine_ate_G2_precomputation &prec_Q1,
+                                                             const alt_bn128_affine_ate_G1_precomputation &prec_P2,
+                                                             const alt_bn128_affine_ate_G2_precomputation &prec_Q2)
+{
+    return alt_bn128_affine_ate_double_miller_loop(prec_P1, prec_Q1, alt_bn128_affine_ate_negate_G1(prec_P2), prec_Q2);
+}
+
+alt_bn128_Fq12 alt_bn128_pp::affine_ate_e_times_e_over_e_miller_loop(const alt_bn128_affine_ate_G1_precomputation &prec_P1,
+                                                                     const alt_bn128_affine_ate_G2_precomputation &prec_Q1,
+                                                                     const alt_bn128_affine_ate_G1_precomputation &prec_P2,
+                                                                     const alt_bn128_affine_ate_G2_precomputation &prec_Q2,
+                                                                     const alt_bn128_affine_ate_G1_precomputation &prec_P3,
+                                                                     const alt_bn128_affine_ate_G2_precomputation &prec_Q3)
+{
+    return (alt_bn128_affine_ate_double_miller_loop(prec_P1, prec_Q1, prec_P2, prec_Q2) *
+            alt_bn128_affine_ate_miller_loop(alt_bn128_affine_ate_negate_G1(prec_P3), prec_Q3));
+}
+
 alt_bn128_Fq12 alt_bn128_pp::double_miller_loop(const alt_bn128_G1_precomp &prec_P1,
                                                 const alt_bn128_G2_precomp &prec_Q1,
                                                 const alt_bn128_G1_precomp &prec_P2,
@@ -43,6 +87,12 @@ alt_bn128_Fq12 alt_bn128_pp::double_miller_loop(const alt_bn128_G1_precomp &prec
     return alt_bn128_double_miller_loop(prec_P1, prec_Q1, prec_P2, prec_Q2);
 }
 
+alt_bn128_Fq12 alt_bn128_pp::multi_miller_loop(const std::vector<alt_bn128_G1_precomp> &prec_P,
+                                               const std::vector<alt_bn128_G2_precomp> &prec_Q)
+{
+    return alt_bn128_multi_miller_loop(prec_P, prec_Q);
+}
+
 alt_bn128_Fq12 alt_bn128_pp::pairing(const alt_bn128_G1 &P,
                                      const alt_bn128_G2 &Q)
 {
@@ -55,4 +105,26 @@ alt_bn128_Fq12 alt_bn128_pp::reduced_pairing(const alt_bn128_G1 &P,
     return alt_bn128_reduced_pairing(P, Q);
 }
 
+alt_bn128_GT alt_bn128_pp::affine_reduced_pairing(const alt_bn128_G1 &P,
+                                                  const alt_bn128_G2 &Q)
+{
+    return alt_bn128_affine_reduced_pairing(P, Q);
+}
+
+alt_bn128_GT alt_bn128_pp::multi_reduced_pairing(const std::vector<alt_bn128_G1> &P,
+                                                 const std::vector<alt_bn128_G2> &Q)
+{
+    return alt_bn128_multi_reduced_pairing(P, Q);
+}
+
+template<>
+bool pairing_product_is_one<alt_bn128_pp>(const std::vector<alt_bn128_G1> &P,
+                                          const std::vector<alt_bn128_G2> &Q)
+{
+    enter_block("Call to pairing_product_is_one");
+    const bool result = (alt_bn128_multi_reduced_pairing(P, Q) == alt_bn128_GT::one());
+    leave_block("Call to pairing_product_is_one");
+    return result;
+}
+
 } // libff
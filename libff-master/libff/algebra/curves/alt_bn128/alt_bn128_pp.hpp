@@ -11,6 +11,7 @@
 #include <libff/algebra/curves/alt_bn128/alt_bn128_g2.hpp>
 #include <libff/algebra/curves/alt_bn128/alt_bn128_init.hpp>
 #include <libff/algebra/curves/alt_bn128/alt_bn128_pairing.hpp>
+#include <libff/algebra/curves/curve_utils.hpp>
 #include <libff/algebra/curves/public_params.hpp>
 
 namespace libff {
@@ -22,12 +23,14 @@ public:
     typedef alt_bn128_G2 G2_type;
     typedef alt_bn128_G1_precomp G1_precomp_type;
     typedef alt_bn128_G2_precomp G2_precomp_type;
+    typedef alt_bn128_affine_ate_G1_precomputation affine_ate_G1_precomp_type;
+    typedef alt_bn128_affine_ate_G2_precomputation affine_ate_G2_precomp_type;
     typedef alt_bn128_Fq Fq_type;
     typedef alt_bn128_Fq2 Fqe_type;
     typedef alt_bn128_Fq12 Fqk_type;
     typedef alt_bn128_GT GT_type;
 
-    static const bool has_affine_pairing = false;
+    static const bool has_affine_pairing = true;
 
     static void init_public_params();
     static alt_bn128_GT final_exponentiation(const alt_bn128_Fq12 &elt);
@@ -35,16 +38,41 @@ public:
     static alt_bn128_G2_precomp precompute_G2(const alt_bn128_G2 &Q);
     static alt_bn128_Fq12 miller_loop(const alt_bn128_G1_precomp &prec_P,
                                       const alt_bn128_G2_precomp &prec_Q);
+    static alt_bn128_affine_ate_G1_precomputation affine_ate_precompute_G1(const alt_bn128_G1 &P);
+    static alt_bn128_affine_ate_G2_precomputation affine_ate_precompute_G2(const alt_bn128_G2 &Q);
+    static alt_bn128_Fq12 affine_ate_miller_loop(const alt_bn128_affine_ate_G1_precomputation &prec_P,
+                                                 const alt_bn128_affine_ate_G2_precomputation &prec_Q);
+    static alt_bn128_Fq12 affine_ate_e_over_e_miller_loop(const alt_bn128_affine_ate_G1_precomputation &prec_P1,
+                                                          const alt_bn128_affine_ate_G2_precomputation &prec_Q1,
+                                                          const alt_bn128_affine_ate_G1_precomputation &prec_P2,
+                                                          const alt_bn128_affine_ate_G2_precomputation &prec_Q2);
+    static alt_bn128_Fq12 affine_ate_e_times_e_over_e_miller_loop(const alt_bn128_affine_ate_G1_precomputation &prec_P1,
+                                                                  const alt_bn128_affine_ate_G2_precomputation &prec_Q1,
+                                                                  const alt_bn128_affine_ate_G1_precomputation &prec_P2,
+                                                                  const alt_bn128_affine_ate_G2_precomputation &prec_Q2,
+                                                                  const alt_bn128_affine_ate_G1_precomputation &prec_P3,
+                                                                  const alt_bn128_affine_ate_G2_precomputation &prec_Q3);
     static alt_bn128_Fq12 double_miller_loop(const alt_bn128_G1_precomp &prec_P1,
                                              const alt_bn128_G2_precomp &prec_Q1,
                                              const alt_bn128_G1_precomp &prec_P2,
                                              const alt_bn128_G2_precomp &prec_Q2);
+    static alt_bn128_Fq12 multi_miller_loop(const std::vector<alt_bn128_G1_precomp> &prec_P,
+                                            const std::vector<alt_bn128_G2_precomp> &prec_Q);
     static alt_bn128_Fq12 pairing(const alt_bn128_G1 &P,
                                   const alt_bn128_G2 &Q);
     static alt_bn128_Fq12 reduced_pairing(const alt_bn128_G1 &P,
                                           const alt_bn128_G2 &Q);
+    static alt_bn128_GT affine_reduced_pairing(const alt_bn128_G1 &P,
+                                               const alt_bn128_G2 &Q);
+    static alt_bn128_GT multi_reduced_pairing(const std::vector<alt_bn128_G1> &P,
+                                              const std::vector<alt_bn128_G2> &Q);
 };
 
+/* precomputes and Miller-loops the pairs in parallel, see alt_bn128_ate_multi_reduced_pairing */
+template<>
+bool pairing_product_is_one<alt_bn128_pp>(const std::vector<alt_bn128_G1> &P,
+                                          const std::vector<alt_bn128_G2> &Q);
+
 } // libff
 
 #endif // ALT_BN128_PP_HPP_
@@ -0,0 +1,197 @@
+/** @file
+ *****************************************************************************
+ Profiling of the alt_bn128 Miller loop against the binary loop it replaced.
+ *****************************************************************************
+ * @author     This file is part of libff, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#include <cstdio>
+#include <vector>
+
+#include <libff/algebra/curves/alt_bn128/alt_bn128_pp.hpp>
+#include <libff/common/profiling.hpp>
+
+using namespace libff;
+
+/*
+  The alt_bn128 Miller loop as it was before the NAF loop and paired line
+  multiplications: a binary loop over alt_bn128_ate_loop_count, one
+  mul_by_024 per line. The baseline of profile_miller_loops.
+*/
+void alt_bn128_binary_doubling_step(const alt_bn128_Fq two_inv, alt_bn128_G2 &current, alt_bn128_ate_ell_coeffs &c)
+{
+    const alt_bn128_Fq2 X = current.X, Y = current.Y, Z = current.Z;
+
+    const alt_bn128_Fq2 A = two_inv * (X * Y);
+    const alt_bn128_Fq2 B = Y.squared();
+    const alt_bn128_Fq2 C = Z.squared();
+    const alt_bn128_Fq2 D = C+C+C;
+    const alt_bn128_Fq2 E = alt_bn128_twist_coeff_b * D;
+    const alt_bn128_Fq2 F = E+E+E;
+    const alt_bn128_Fq2 G = two_inv * (B+F);
+    const alt_bn128_Fq2 H = (Y+Z).squared() - (B+C);
+    const alt_bn128_Fq2 I = E-B;
+    const alt_bn128_Fq2 J = X.squared();
+    const alt_bn128_Fq2 E_squared = E.squared();
+
+    current.X = A * (B-F);
+    current.Y = G.squared() - (E_squared+E_squared+E_squared);
+    current.Z = B * H;
+    c.ell_0 = alt_bn128_twist * I;
+    c.ell_VW = -H;
+    c.ell_VV = J+J+J;
+}
+
+void alt_bn128_binary_addition_step(const alt_bn128_G2 &base, alt_bn128_G2 &current, alt_bn128_ate_ell_coeffs &c)
+{
+    const alt_bn128_Fq2 X1 = current.X, Y1 = current.Y, Z1 = current.Z;
+    const alt_bn128_Fq2 &x2 = base.X, &y2 = base.Y;
+
+    const alt_bn128_Fq2 D = X1 - x2 * Z1;
+    const alt_bn128_Fq2 E = Y1 - y2 * Z1;
+    const alt_bn128_Fq2 F = D.squared();
+    const alt_bn128_Fq2 G = E.squared();
+    const alt_bn128_Fq2 H = D*F;
+    const alt_bn128_Fq2 I = X1 * F;
+    const alt_bn128_Fq2 J = H + Z1*G - (I+I);
+
+    current.X = D * J;
+    current.Y = E * (I-J)-(H * Y1);
+    current.Z = Z1 * H;
+    c.ell_0 = alt_bn128_twist * (E * x2 - D * y2);
+    c.ell_VV = - E;
+    c.ell_VW = D;
+}
+
+std::vector<alt_bn128_ate_ell_coeffs> alt_bn128_binary_precompute_G2(const alt_bn128_G2 &Q)
+{
+    alt_bn128_G2 Qcopy(Q);
+    Qcopy.to_affine_coordinates();
+    const alt_bn128_Fq two_inv = alt_bn128_Fq("2").inverse();
+
+    std::vector<alt_bn128_ate_ell_coeffs> coeffs;
+    alt_bn128_G2 R = Qcopy;
+    alt_bn128_ate_ell_coeffs c;
+
+    const bigint<alt_bn128_q_limbs> &loop_count = alt_bn128_ate_loop_count;
+    for (long i = loop_count.num_bits() - 2; i >= 0; --i)
+    {
+        alt_bn128_binary_doubling_step(two_inv, R, c);
+        coeffs.push_back(c);
+        if (loop_count.test_bit(i))
+        {
+            alt_bn128_binary_addition_step(Qcopy, R, c);
+            coeffs.push_back(c);
+        }
+    }
+
+    alt_bn128_G2 Q1 = Qcopy.mul_by_q();
+    alt_bn128_G2 Q2 = Q1.mul_by_q();
+    if (alt_bn128_ate_is_loop_count_neg)
+    {
+        R.Y = - R.Y;
+    }
+    Q2.Y = - Q2.Y;
+
+    alt_bn128_binary_addition_step(Q1, R, c);
+    coeffs.push_back(c);
+    alt_bn128_binary_addition_step(Q2, R, c);
+    coeffs.push_back(c);
+
+    return coeffs;
+}
+
+alt_bn128_Fq12 alt_bn128_binary_miller_loop(const alt_bn128_ate_G1_precomp &prec_P,
+                                            const std::vector<alt_bn128_ate_ell_coeffs> &coeffs)
+{
+    alt_bn128_Fq12 f = alt_bn128_Fq12::one();
+    size_t idx = 0;
+
+    const bigint<alt_bn128_q_limbs> &loop_count = alt_bn128_ate_loop_count;
+    for (long i = loop_count.num_bits() - 2; i >= 0; --i)
+    {
+        const alt_bn128_ate_ell_coeffs &c = coeffs[idx++];
+        f = f.squared();
+        f = f.mul_by_024(c.ell_0, prec_P.PY * c.ell_VW, prec_P.PX * c.ell_VV);
+        if (loop_count.test_bit(i))
+        {
+            const alt_bn128_ate_ell_coeffs &c = coeffs[idx++];
+            f = f.mul_by_024(c.ell_0, prec_P.PY * c.ell_VW, prec_P.PX * c.ell_VV);
+        }
+    }
+
+    if (alt_bn128_ate_is_loop_count_neg)
+    {
+        f = f.inverse();
+    }
+
+    for (size_t j = 0; j < 2; ++j)
+    {
+        const alt_bn128_ate_ell_coeffs &c = coeffs[idx++];
+        f = f.mul_by_024(c.ell_0, prec_P.PY * c.ell_VW, prec_P.PX * c.ell_VV);
+    }
+
+    return f;
+}
+
+/* the binary Miller loop against the current one, which must agree with it after the final exponentiation */
+void profile_miller_loops()
+{
+    const size_t num_pairs = 8;
+    const size_t iterations = 20;
+    std::vector<alt_bn128_ate_G1_precomp> prec_P;
+    std::vector<alt_bn128_ate_G2_precomp> prec_Q;
+    std::vector<std::vector<alt_bn128_ate_ell_coeffs> > binary_coeffs;
+    for (size_t i = 0; i < num_pairs; ++i)
+    {
+        const alt_bn128_G2 Q = (alt_bn128_Fr::random_element()) * alt_bn128_G2::one();
+        prec_P.emplace_back(alt_bn128_ate_precompute_G1((alt_bn128_Fr::random_element()) * alt_bn128_G1::one()));
+        prec_Q.emplace_back(alt_bn128_ate_precompute_G2(Q));
+        binary_coeffs.emplace_back(alt_bn128_binary_precompute_G2(Q));
+    }
+
+    std::vector<alt_bn128_Fq12> binary(num_pairs);
+    long long start = get_nsec_time();
+    for (size_t k = 0; k < iterations; ++k)
+    {
+        for (size_t i = 0; i < num_pairs; ++i)
+        {
+            binary[i] = alt_bn128_binary_miller_loop(prec_P[i], binary_coeffs[i]);
+        }
+    }
+    const long long binary_time = get_nsec_time() - start;
+
+    std::vector<alt_bn128_Fq12> current(num_pairs);
+    start = get_nsec_time();
+    for (size_t k = 0; k < iterations; ++k)
+    {
+        for (size_t i = 0; i < num_pairs; ++i)
+        {
+            current[i] = alt_bn128_ate_miller_loop(prec_P[i], prec_Q[i]);
+        }
+    }
+    const long long current_time = get_nsec_time() - start;
+
+    for (size_t i = 0; i < num_pairs; ++i)
+    {
+        if (alt_bn128_final_exponentiation(binary[i]) != alt_bn128_final_exponentiation(current[i]))
+        {
+            fprintf(stderr, "Answers NOT MATCHING (binary and NAF Miller loops)\n");
+        }
+    }
+    printf("alt_bn128: %.2f us per binary Miller loop, %.2f us per NAF Miller loop\n",
+           double(binary_time) / (iterations * num_pairs * 1000),
+           double(current_time) / (iterations * num_pairs * 1000));
+}
+
+int main(void)
+{
+    print_compilation_info();
+
+    alt_bn128_pp::init_public_params();
+    profile_miller_loops();
+
+    return 0;
+}
@@ -6,7 +6,7 @@
  *****************************************************************************/
 
 #include <libff/algebra/curves/bn128/bn128_g1.hpp>
-#include <libff/algebra/curves/bn128/bn_utils.hpp>
+#include <libff/algebra/fields/field_utils.hpp>
 
 namespace libff {
 
@@ -21,56 +21,6 @@ bn128_G1 bn128_G1::G1_zero = {};
 bn128_G1 bn128_G1::G1_one = {};
 bool bn128_G1::initialized = false;
 
-bn::Fp bn128_G1::sqrt(const bn::Fp &el)
-{
-    size_t v = bn128_Fq_s;
-    bn::Fp z = bn128_Fq_nqr_to_t;
-    bn::Fp w = mie::power(el, bn128_Fq_t_minus_1_over_2);
-    bn::Fp x = el * w;
-    bn::Fp b = x * w;
-
-#if DEBUG
-    // check if square with Euler's criterion
-    bn::Fp check = b;
-    for (size_t i = 0; i < v-1; ++i)
-    {
-        bn::Fp::square(check, check);
-    }
-
-    assert(check == bn::Fp(1));
-#endif
-
-    // compute square root with Tonelli--Shanks
-    // (does not terminate if not a square!)
-
-    while (b != bn::Fp(1))
-    {
-        size_t m = 0;
-        bn::Fp b2m = b;
-        while (b2m != bn::Fp(1))
-        {
-            // invariant: b2m = b^(2^m) after entering this loop
-            bn::Fp::square(b2m, b2m);
-            m += 1;
-        }
-
-        int j = v-m-1;
-        w = z;
-        while (j > 0)
-        {
-            bn::Fp::square(w, w);
-            --j;
-        } // w = z^2^(v-m-1)
-
-        z = w * w;
-        b = b * z;
-        x = x * w;
-        v = m;
-    }
-
-    return x;
-}
-
 bn128_G1::bn128_G1()
 {
     if (bn128_G1::initialized)
@@ -452,7 +402,7 @@ std::istream& operator>>(std::istream &in, bn128_G1 &g)
         bn::Fp::mul(tY2, tX2, tX);
         bn::Fp::add(tY2, tY2, bn128_coeff_b);
 
-        g.Y = bn128_G1::sqrt(tY2);
+        g.Y = bn128_ate_Fq(tY2).sqrt().el;
         if ((((unsigned char*)&g.Y)[0] & 1) != Y_lsb)
         {
             bn::Fp::neg(g.Y, g.Y);
@@ -504,22 +454,22 @@ std::istream& operator>>(std::istream& in, std::vector<bn128_G1> &v)
 
 void bn128_G1::batch_to_special_all_non_zeros(std::vector<bn128_G1> &vec)
 {
-    std::vector<bn::Fp> Z_vec;
+    std::vector<bn128_ate_Fq> Z_vec;
     Z_vec.reserve(vec.size());
 
     for (auto &el: vec)
     {
         Z_vec.emplace_back(el.Z);
     }
-    bn_batch_invert<bn::Fp>(Z_vec);
+    batch_invert<bn128_ate_Fq>(Z_vec);
 
     const bn::Fp one = 1;
 
     for (size_t i = 0; i < vec.size(); ++i)
     {
         bn::Fp Z2, Z3;
-        bn::Fp::square(Z2, Z_vec[i]);
-        bn::Fp::mul(Z3, Z2, Z_vec[i]);
+        bn::Fp::square(Z2, Z_vec[i].el);
+        bn::Fp::mul(Z3, Z2, Z_vec[i].el);
 
         bn::Fp::mul(vec[i].X, vec[i].X, Z2);
         bn::Fp::mul(vec[i].Y, vec[i].Y, Z3);
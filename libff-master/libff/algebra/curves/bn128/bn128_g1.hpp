@@ -21,8 +21,6 @@ std::ostream& operator<<(std::ostream &, const bn128_G1&);
 std::istream& operator>>(std::istream &, bn128_G1&);
 
 class bn128_G1 {
-private:
-    static bn::Fp sqrt(const bn::Fp &el);
 public:
 #ifdef PROFILE_OP_COUNTS
     static long long add_cnt;
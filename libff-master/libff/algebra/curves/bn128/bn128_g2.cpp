@@ -6,7 +6,7 @@
  *****************************************************************************/
 
 #include <libff/algebra/curves/bn128/bn128_g2.hpp>
-#include <libff/algebra/curves/bn128/bn_utils.hpp>
+#include <libff/algebra/fields/field_utils.hpp>
 
 namespace libff {
 
@@ -21,56 +21,6 @@ bn128_G2 bn128_G2::G2_zero = {};
 bn128_G2 bn128_G2::G2_one = {};
 bool bn128_G2::initialized = false;
 
-bn::Fp2 bn128_G2::sqrt(const bn::Fp2 &el)
-{
-    size_t v = bn128_Fq2_s;
-    bn::Fp2 z = bn128_Fq2_nqr_to_t;
-    bn::Fp2 w = mie::power(el, bn128_Fq2_t_minus_1_over_2);
-    bn::Fp2 x = el * w;
-    bn::Fp2 b = x * w;
-
-#if DEBUG
-    // check if square with Euler's criterion
-    bn::Fp2 check = b;
-    for (size_t i = 0; i < v-1; ++i)
-    {
-        bn::Fp2::square(check, check);
-    }
-
-    assert(check == bn::Fp2(bn::Fp(1), bn::Fp(0)));
-#endif
-
-    // compute square root with Tonelli--Shanks
-    // (does not terminate if not a square!)
-
-    while (b != bn::Fp2(1))
-    {
-        size_t m = 0;
-        bn::Fp2 b2m = b;
-        while (b2m != bn::Fp2(bn::Fp(1), bn::Fp(0)))
-        {
-            // invariant: b2m = b^(2^m) after entering this loop
-            bn::Fp2::square(b2m, b2m);
-            m += 1;
-        }
-
-        int j = v-m-1;
-        w = z;
-        while (j > 0)
-        {
-            bn::Fp2::square(w, w);
-            --j;
-        } // w = z^2^(v-m-1)
-
-        z = w * w;
-        b = b * z;
-        x = x * w;
-        v = m;
-    }
-
-    return x;
-}
-
 bn128_G2::bn128_G2()
 {
     if (bn128_G2::initialized)
@@ -465,7 +415,7 @@ std::istream& operator>>(std::istream &in, bn128_G2 &g)
         bn::Fp2::mul(tY2, tX2, tX);
         bn::Fp2::add(tY2, tY2, bn128_twist_coeff_b);
 
-        g.Y = bn128_G2::sqrt(tY2);
+        g.Y = bn128_ate_Fq2(tY2).sqrt().el;
         if ((((unsigned char*)&g.Y.a_)[0] & 1) != Y_lsb)
         {
             bn::Fp2::neg(g.Y, g.Y);
@@ -488,22 +438,22 @@ std::istream& operator>>(std::istream &in, bn128_G2 &g)
 
 void bn128_G2::batch_to_special_all_non_zeros(std::vector<bn128_G2> &vec)
 {
-    std::vector<bn::Fp2> Z_vec;
+    std::vector<bn128_ate_Fq2> Z_vec;
     Z_vec.reserve(vec.size());
 
     for (auto &el: vec)
     {
         Z_vec.emplace_back(el.Z);
     }
-    bn_batch_invert<bn::Fp2>(Z_vec);
+    batch_invert<bn128_ate_Fq2>(Z_vec);
 
     const bn::Fp2 one = 1;
 
     for (size_t i = 0; i < vec.size(); ++i)
     {
         bn::Fp2 Z2, Z3;
-        bn::Fp2::square(Z2, Z_vec[i]);
-        bn::Fp2::mul(Z3, Z2, Z_vec[i]);
+        bn::Fp2::square(Z2, Z_vec[i].el);
+        bn::Fp2::mul(Z3, Z2, Z_vec[i].el);
 
         bn::Fp2::mul(vec[i].X, vec[i].X, Z2);
         bn::Fp2::mul(vec[i].Y, vec[i].Y, Z3);
@@ -22,8 +22,6 @@ std::ostream& operator<<(std::ostream &, const bn128_G2&);
 std::istream& operator>>(std::istream &, bn128_G2&);
 
 class bn128_G2 {
-private:
-    static bn::Fp2 sqrt(const bn::Fp2 &el);
 public:
 #ifdef PROFILE_OP_COUNTS
     static long long add_cnt;
@@ -16,14 +16,8 @@ bigint<bn128_r_limbs> bn128_modulus_r;
 bigint<bn128_q_limbs> bn128_modulus_q;
 
 bn::Fp bn128_coeff_b;
-size_t bn128_Fq_s;
-bn::Fp bn128_Fq_nqr_to_t;
-mie::Vuint bn128_Fq_t_minus_1_over_2;
 
 bn::Fp2 bn128_twist_coeff_b;
-size_t bn128_Fq2_s;
-bn::Fp2 bn128_Fq2_nqr_to_t;
-mie::Vuint bn128_Fq2_t_minus_1_over_2;
 
 void init_bn128_params()
 {
@@ -49,6 +43,7 @@ void init_bn128_params()
         bn128_Fr::Rcubed = bigint_r("5866548545943845227489894872040244720403868105578784105281690076696998248512");
         bn128_Fr::inv = 0xefffffff;
     }
+    bn128_Fr::init_jit();
     bn128_Fr::num_bits = 254;
     bn128_Fr::euler = bigint_r("10944121435919637611123202872628637544274182200208017171849102093287904247808");
     bn128_Fr::s = 28;
@@ -74,6 +69,7 @@ void init_bn128_params()
         bn128_Fq::Rcubed = bigint_q("14921786541159648185948152738563080959093619838510245177710943249661917737183");
         bn128_Fq::inv = 0xe4866389;
     }
+    bn128_Fq::init_jit();
     bn128_Fq::num_bits = 254;
     bn128_Fq::euler = bigint_q("10944121435919637611123202872628637544348155578648911831344518947322613104291");
     bn128_Fq::s = 1;
@@ -86,16 +82,18 @@ void init_bn128_params()
 
     /* additional parameters for square roots in Fq/Fq2 */
     bn128_coeff_b = bn::Fp(3);
-    bn128_Fq_s = 1;
-    bn128_Fq_nqr_to_t = bn::Fp("21888242871839275222246405745257275088696311157297823662689037894645226208582");
-    bn128_Fq_t_minus_1_over_2 = mie::Vuint("5472060717959818805561601436314318772174077789324455915672259473661306552145");
+    bn128_ate_Fq::num_bits = bn128_q_bitcount;
+    bn128_ate_Fq::s = 1;
+    bn128_ate_Fq::nqr_to_t = bn::Fp("21888242871839275222246405745257275088696311157297823662689037894645226208582");
+    bn128_ate_Fq::t_minus_1_over_2 = mie::Vuint("5472060717959818805561601436314318772174077789324455915672259473661306552145");
 
     bn128_twist_coeff_b = bn::Fp2(bn::Fp("19485874751759354771024239261021720505790618469301721065564631296452457478373"),
                                   bn::Fp("266929791119991161246907387137283842545076965332900288569378510910307636690"));
-    bn128_Fq2_s = 4;
-    bn128_Fq2_nqr_to_t = bn::Fp2(bn::Fp("5033503716262624267312492558379982687175200734934877598599011485707452665730"),
-                                 bn::Fp("314498342015008975724433667930697407966947188435857772134235984660852259084"));
-    bn128_Fq2_t_minus_1_over_2 = mie::Vuint("14971724250519463826312126413021210649976634891596900701138993820439690427699319920245032869357433499099632259837909383182382988566862092145199781964621");
+    bn128_ate_Fq2::num_bits = 2 * bn128_q_bitcount;
+    bn128_ate_Fq2::s = 4;
+    bn128_ate_Fq2::nqr_to_t = bn::Fp2(bn::Fp("5033503716262624267312492558379982687175200734934877598599011485707452665730"),
+                                      bn::Fp("314498342015008975724433667930697407966947188435857772134235984660852259084"));
+    bn128_ate_Fq2::t_minus_1_over_2 = mie::Vuint("14971724250519463826312126413021210649976634891596900701138993820439690427699319920245032869357433499099632259837909383182382988566862092145199781964621");
 
     /* choice of group G1 */
     bn128_G1::G1_zero.X = bn::Fp(1);
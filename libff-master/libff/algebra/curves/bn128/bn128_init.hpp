@@ -9,6 +9,7 @@
 #define BN128_INIT_HPP_
 #include "depends/ate-pairing/include/bn.h"
 
+#include <libff/algebra/curves/bn128/bn_field.hpp>
 #include <libff/algebra/curves/public_params.hpp>
 #include <libff/algebra/fields/fp.hpp>
 
@@ -24,18 +25,16 @@ extern bigint<bn128_r_limbs> bn128_modulus_r;
 extern bigint<bn128_q_limbs> bn128_modulus_q;
 
 extern bn::Fp bn128_coeff_b;
-extern size_t bn128_Fq_s;
-extern bn::Fp bn128_Fq_nqr_to_t;
-extern mie::Vuint bn128_Fq_t_minus_1_over_2;
 
 extern bn::Fp2 bn128_twist_coeff_b;
-extern size_t bn128_Fq2_s;
-extern bn::Fp2 bn128_Fq2_nqr_to_t;
-extern mie::Vuint bn128_Fq2_t_minus_1_over_2;
 
 typedef Fp_model<bn128_r_limbs, bn128_modulus_r> bn128_Fr;
 typedef Fp_model<bn128_q_limbs, bn128_modulus_q> bn128_Fq;
 
+/* the ate-pairing library's own Fq and Fq2, with the interface of Fp_model */
+typedef bn_field<bn::Fp> bn128_ate_Fq;
+typedef bn_field<bn::Fp2> bn128_ate_Fq2;
+
 void init_bn128_params();
 
 class bn128_G1;
@@ -8,6 +8,7 @@
  * @copyright  MIT license (see LICENSE file)
  *******************************************************************************/
 
+#include <cassert>
 #include <sstream>
 
 #include <libff/algebra/curves/bn128/bn128_g1.hpp>
@@ -205,6 +206,68 @@ bn128_Fq12 bn128_double_ate_miller_loop(const bn128_ate_G1_precomp &prec_P1,
     return f;
 }
 
+/* f <- f * (product of the lines prec_Q[j].coeffs[idx] evaluated at prec_P[j]), two lines at a time */
+static void bn128_multi_ate_mul_lines(bn::Fp12 &f,
+                                      const std::vector<bn128_ate_G1_precomp> &prec_P,
+                                      const std::vector<bn128_ate_G2_precomp> &prec_Q,
+                                      const size_t idx)
+{
+    bn::Fp12 t;
+    bn::Fp6 l1, l2;
+    size_t j = 0;
+    for (; j + 1 < prec_P.size(); j += 2)
+    {
+        l1 = prec_Q[j].coeffs[idx];
+        l2 = prec_Q[j+1].coeffs[idx];
+        bn::Fp6::mulFp6_24_Fp_01(l1, prec_P[j].P);
+        bn::Fp6::mulFp6_24_Fp_01(l2, prec_P[j+1].P);
+        bn::Fp12::Dbl::mul_Fp2_024_Fp2_024(t, l1, l2);
+        bn::Fp12::mul(f, f, t);
+    }
+    if (j < prec_P.size())
+    {
+        l1 = prec_Q[j].coeffs[idx];
+        bn::Fp6::mulFp6_24_Fp_01(l1, prec_P[j].P);
+        bn::Fp12::Dbl::mul_Fp2_024(f, l1);
+    }
+}
+
+bn128_Fq12 bn128_multi_ate_miller_loop(const std::vector<bn128_ate_G1_precomp> &prec_P,
+                                       const std::vector<bn128_ate_G2_precomp> &prec_Q)
+{
+    assert(prec_P.size() == prec_Q.size());
+    assert(bn::Param::siTbl[1] == 1);
+
+    /* same schedule as bn::components::millerLoop, with the squaring of f
+       shared by all pairs */
+    bn128_Fq12 f;
+    f.elem = bn::Fp12(1);
+    size_t idx = 0;
+
+    bn128_multi_ate_mul_lines(f.elem, prec_P, prec_Q, idx++);
+    bn128_multi_ate_mul_lines(f.elem, prec_P, prec_Q, idx++);
+    for (size_t i = 2; i < bn::Param::siTbl.size(); ++i)
+    {
+        bn::Fp12::square(f.elem);
+        bn128_multi_ate_mul_lines(f.elem, prec_P, prec_Q, idx++);
+
+        if (bn::Param::siTbl[i])
+        {
+            bn128_multi_ate_mul_lines(f.elem, prec_P, prec_Q, idx++);
+        }
+    }
+
+#ifndef BN_SUPPORT_SNARK
+    // z < 0
+    bn::Fp6::neg(f.elem.b_, f.elem.b_);
+#endif
+
+    bn128_multi_ate_mul_lines(f.elem, prec_P, prec_Q, idx++);
+    bn128_multi_ate_mul_lines(f.elem, prec_P, prec_Q, idx++);
+
+    return f;
+}
+
 bn128_GT bn128_final_exponentiation(const bn128_Fq12 &elt)
 {
     enter_block("Call to bn128_final_exponentiation");
@@ -46,6 +46,8 @@ bn128_Fq12 bn128_double_ate_miller_loop(const bn128_ate_G1_precomp &prec_P1,
                                         const bn128_ate_G2_precomp &prec_Q2);
 bn128_Fq12 bn128_ate_miller_loop(const bn128_ate_G1_precomp &prec_P,
                                  const bn128_ate_G2_precomp &prec_Q);
+bn128_Fq12 bn128_multi_ate_miller_loop(const std::vector<bn128_ate_G1_precomp> &prec_P,
+                                       const std::vector<bn128_ate_G2_precomp> &prec_Q);
 
 bn128_GT bn128_final_exponentiation(const bn128_Fq12 &elt);
 
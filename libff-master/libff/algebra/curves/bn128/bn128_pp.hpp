@@ -39,6 +39,8 @@ public:
                                          const bn128_ate_G2_precomp &prec_Q1,
                                          const bn128_ate_G1_precomp &prec_P2,
                                          const bn128_ate_G2_precomp &prec_Q2);
+    static bn128_Fq12 multi_miller_loop(const std::vector<bn128_ate_G1_precomp> &prec_P,
+                                        const std::vector<bn128_ate_G2_precomp> &prec_Q);
 
     /* the following are used in test files */
     static bn128_GT pairing(const bn128_G1 &P,
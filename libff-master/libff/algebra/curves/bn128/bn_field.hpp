@@ -0,0 +1,101 @@
+/** @file
+ *****************************************************************************
+ Declaration of an adapter giving the fields of the ate-pairing library the
+ interface of Fp_model.
+ *****************************************************************************
+ * @author     This file is part of libff, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef BN_FIELD_HPP_
+#define BN_FIELD_HPP_
+#include <iostream>
+
+#include "depends/ate-pairing/include/bn.h"
+
+#include <libff/algebra/fields/bigint.hpp>
+
+namespace libff {
+
+template<typename BnT> class bn_field;
+template<typename BnT> std::ostream& operator<<(std::ostream &, const bn_field<BnT>&);
+template<typename BnT> std::istream& operator>>(std::istream &, bn_field<BnT>&);
+
+/**
+ * A bn::Fp or bn::Fp2 element of the ate-pairing library, whose arithmetic
+ * is generated at runtime, with the interface of Fp_model (zero(), one(),
+ * squared(), inverse(), sqrt(), operators, ...), so that generic algorithms
+ * such as batch_invert run on it. The wrapped element is the only member, and
+ * is public, so that bn128 code can convert freely.
+ */
+template<typename BnT>
+class bn_field {
+public:
+    BnT el;
+
+    static size_t num_bits;
+    static size_t s; // modulus = 2^s * t + 1, for the field order
+    static mie::Vuint t_minus_1_over_2; // (t-1)/2
+    static BnT nqr_to_t; // nqr^t, for a quadratic nonresidue nqr
+
+    bn_field() {};
+    bn_field(const BnT &el) : el(el) {};
+    bn_field(const long x);
+    /* only for bn::Fp */
+    template<mp_size_t n>
+    explicit bn_field(const bigint<n> &b);
+
+    /* the standard representation, only for bn::Fp */
+    bigint<bn::Fp::N> as_bigint() const;
+
+    bool operator==(const bn_field &other) const { return el == other.el; }
+    bool operator!=(const bn_field &other) const { return !(el == other.el); }
+    bool is_zero() const { return el.isZero(); }
+
+    void print() const { std::cout << el << "\n"; }
+
+    bn_field& operator+=(const bn_field &other) { BnT::add(el, el, other.el); return *this; }
+    bn_field& operator-=(const bn_field &other) { BnT::sub(el, el, other.el); return *this; }
+    bn_field& operator*=(const bn_field &other) { BnT::mul(el, el, other.el); return *this; }
+
+    bn_field operator+(const bn_field &other) const { bn_field r; BnT::add(r.el, el, other.el); return r; }
+    bn_field operator-(const bn_field &other) const { bn_field r; BnT::sub(r.el, el, other.el); return r; }
+    bn_field operator*(const bn_field &other) const { bn_field r; BnT::mul(r.el, el, other.el); return r; }
+    bn_field operator-() const { bn_field r; BnT::neg(r.el, el); return r; }
+    bn_field squared() const { bn_field r; BnT::square(r.el, el); return r; }
+    bn_field& invert() { el.inverse(); return *this; }
+    bn_field inverse() const { bn_field r(*this); return r.invert(); }
+    bn_field sqrt() const; // HAS TO BE A SQUARE (else does not terminate)
+
+    bn_field operator^(const unsigned long pow) const;
+    template<mp_size_t m>
+    bn_field operator^(const bigint<m> &pow) const;
+
+    static size_t size_in_bits() { return num_bits; }
+    static size_t capacity() { return num_bits - 1; }
+
+    static bn_field zero() { return bn_field(0); }
+    static bn_field one() { return bn_field(1); }
+    static bn_field random_element();
+
+    friend std::ostream& operator<< <BnT>(std::ostream &out, const bn_field<BnT> &p);
+    friend std::istream& operator>> <BnT>(std::istream &in, bn_field<BnT> &p);
+};
+
+template<typename BnT>
+size_t bn_field<BnT>::num_bits;
+
+template<typename BnT>
+size_t bn_field<BnT>::s;
+
+template<typename BnT>
+mie::Vuint bn_field<BnT>::t_minus_1_over_2;
+
+template<typename BnT>
+BnT bn_field<BnT>::nqr_to_t;
+
+} // libff
+#include <libff/algebra/curves/bn128/bn_field.tcc>
+
+#endif // BN_FIELD_HPP_
@@ -0,0 +1,178 @@
+/** @file
+ *****************************************************************************
+ Implementation of an adapter giving the fields of the ate-pairing library the
+ interface of Fp_model.
+ *****************************************************************************
+ * @author     This file is part of libff, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef BN_FIELD_TCC_
+#define BN_FIELD_TCC_
+#include <algorithm>
+#include <cstdint>
+
+#include <libff/algebra/exponentiation/exponentiation.hpp>
+
+namespace libff {
+
+/* embed an element of the base field */
+inline void bn_field_set_base(bn::Fp &el, const bn::Fp &a)
+{
+    el = a;
+}
+
+inline void bn_field_set_base(bn::Fp2 &el, const bn::Fp &a)
+{
+    el = bn::Fp2(a, bn::Fp(0));
+}
+
+template<typename BnT>
+bn_field<BnT>::bn_field(const long x)
+{
+    const uint64_t abs_x = (x < 0 ? -static_cast<uint64_t>(x) : static_cast<uint64_t>(x));
+    bn::Fp a(mie::Vuint(&abs_x, 1));
+    if (x < 0)
+    {
+        bn::Fp::neg(a, a);
+    }
+    bn_field_set_base(el, a);
+}
+
+template<typename BnT>
+template<mp_size_t n>
+bn_field<BnT>::bn_field(const bigint<n> &b) :
+    el(mie::Vuint(reinterpret_cast<const mie::Unit*>(b.data), n))
+{
+}
+
+template<typename BnT>
+bigint<bn::Fp::N> bn_field<BnT>::as_bigint() const
+{
+    const mie::Vuint v = el.get();
+    bigint<bn::Fp::N> res;
+    for (size_t i = 0; i < std::min<size_t>(v.size(), bn::Fp::N); ++i)
+    {
+        res.data[i] = v[i];
+    }
+    return res;
+}
+
+template<typename BnT>
+bn_field<BnT> bn_field<BnT>::sqrt() const
+{
+    size_t v = s;
+    bn_field z(nqr_to_t);
+    bn_field w(mie::power(el, t_minus_1_over_2));
+    bn_field x = (*this) * w;
+    bn_field b = x * w; // b = (*this)^t
+
+    const bn_field one = bn_field::one();
+
+#if DEBUG
+    // check if square with Euler's criterion
+    bn_field check = b;
+    for (size_t i = 0; i < v-1; ++i)
+    {
+        check = check.squared();
+    }
+
+    assert(check == one);
+#endif
+
+    // compute square root with Tonelli--Shanks
+    // (does not terminate if not a square!)
+
+    while (b != one)
+    {
+        size_t m = 0;
+        bn_field b2m = b;
+        while (b2m != one)
+        {
+            // invariant: b2m = b^(2^m) after entering this loop
+            b2m = b2m.squared();
+            m += 1;
+        }
+
+        int j = v-m-1;
+        w = z;
+        while (j > 0)
+        {
+            w = w.squared();
+            --j;
+        } // w = z^2^(v-m-1)
+
+        z = w.squared();
+        b = b * z;
+        x = x * w;
+        v = m;
+    }
+
+    return x;
+}
+
+template<typename BnT>
+bn_field<BnT> bn_field<BnT>::operator^(const unsigned long pow) const
+{
+    return power<bn_field<BnT> >(*this, pow);
+}
+
+template<typename BnT>
+template<mp_size_t m>
+bn_field<BnT> bn_field<BnT>::operator^(const bigint<m> &pow) const
+{
+    return power<bn_field<BnT>, m>(*this, pow);
+}
+
+template<>
+inline bn_field<bn::Fp> bn_field<bn::Fp>::random_element()
+{
+    const mie::Vuint &modulus = bn::Fp::getModulo();
+    bigint<bn::Fp::N> r;
+    mie::Vuint v;
+    do
+    {
+        r.randomize();
+        // clear the bits above the modulus length
+        for (size_t i = num_bits; i < r.max_bits(); ++i)
+        {
+            r.data[i / GMP_NUMB_BITS] &= ~(1ul << (i % GMP_NUMB_BITS));
+        }
+        v = mie::Vuint(reinterpret_cast<const mie::Unit*>(r.data), bn::Fp::N);
+    } while (!(v < modulus));
+
+    return bn_field<bn::Fp>(bn::Fp(v));
+}
+
+template<>
+inline bn_field<bn::Fp2> bn_field<bn::Fp2>::random_element()
+{
+    return bn_field<bn::Fp2>(bn::Fp2(bn_field<bn::Fp>::random_element().el,
+                                     bn_field<bn::Fp>::random_element().el));
+}
+
+template<typename BnT>
+std::ostream& operator<<(std::ostream &out, const bn_field<BnT> &p)
+{
+#ifndef BINARY_OUTPUT
+    out << p.el;
+#else
+    out.write((char*) &p.el, sizeof(p.el));
+#endif
+    return out;
+}
+
+template<typename BnT>
+std::istream& operator>>(std::istream &in, bn_field<BnT> &p)
+{
+#ifndef BINARY_OUTPUT
+    in >> p.el;
+#else
+    in.read((char*) &p.el, sizeof(p.el));
+#endif
+    return in;
+}
+
+} // libff
+#endif // BN_FIELD_TCC_
@@ -8,7 +8,9 @@
 #ifndef CURVE_UTILS_HPP_
 #define CURVE_UTILS_HPP_
 #include <cstdint>
+#include <vector>
 
+#include <libff/algebra/curves/public_params.hpp>
 #include <libff/algebra/fields/bigint.hpp>
 
 namespace libff {
@@ -16,6 +18,14 @@ namespace libff {
 template<typename GroupT, mp_size_t m>
 GroupT scalar_mul(const GroupT &base, const bigint<m> &scalar);
 
+/**
+ * Whether the product of the reduced pairings of (P[i], Q[i]) is one, with one
+ * multi-Miller loop and one final exponentiation.
+ */
+template<typename EC_ppT>
+bool pairing_product_is_one(const std::vector<G1<EC_ppT> > &P,
+                            const std::vector<G2<EC_ppT> > &Q);
+
 } // libff
 #include <libff/algebra/curves/curve_utils.tcc>
 
@@ -8,6 +8,10 @@
 #ifndef CURVE_UTILS_TCC_
 #define CURVE_UTILS_TCC_
 
+#include <cassert>
+
+#include <libff/common/profiling.hpp>
+
 namespace libff {
 
 template<typename GroupT, mp_size_t m>
@@ -33,5 +37,27 @@ GroupT scalar_mul(const GroupT &base, const bigint<m> &scalar)
     return result;
 }
 
+template<typename EC_ppT>
+bool pairing_product_is_one(const std::vector<G1<EC_ppT> > &P,
+                            const std::vector<G2<EC_ppT> > &Q)
+{
+    enter_block("Call to pairing_product_is_one");
+    assert(P.size() == Q.size());
+
+    std::vector<G1_precomp<EC_ppT> > prec_P;
+    std::vector<G2_precomp<EC_ppT> > prec_Q;
+    prec_P.reserve(P.size());
+    prec_Q.reserve(Q.size());
+    for (size_t i = 0; i < P.size(); ++i)
+    {
+        prec_P.emplace_back(EC_ppT::precompute_G1(P[i]));
+        prec_Q.emplace_back(EC_ppT::precompute_G2(Q[i]));
+    }
+
+    const GT<EC_ppT> result = EC_ppT::final_exponentiation(EC_ppT::multi_miller_loop(prec_P, prec_Q));
+    leave_block("Call to pairing_product_is_one");
+    return result == GT<EC_ppT>::one();
+}
+
 } // libff
 #endif // CURVE_UTILS_TCC_
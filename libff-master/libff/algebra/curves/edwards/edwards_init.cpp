@@ -57,6 +57,7 @@ void init_edwards_params()
         edwards_Fr::Rcubed = bigint_r("899968968216802386013510389846941393831065658679774050");
         edwards_Fr::inv = 0x7fffffff;
     }
+    edwards_Fr::init_jit();
     edwards_Fr::num_bits = 181;
     edwards_Fr::euler = bigint_r("776255515051215125618400780672310996630960448785612800");
     edwards_Fr::s = 31;
@@ -83,6 +84,7 @@ void init_edwards_params()
         edwards_Fq::Rcubed = bigint_q("1081560488703514202058739223469726982199727506489234349");
         edwards_Fq::inv = 0x7fffffff;
     }
+    edwards_Fq::init_jit();
     edwards_Fq::num_bits = 183;
     edwards_Fq::euler = bigint_q("3105022060204860502473603120442989137261875634896896000");
     edwards_Fq::s = 31;
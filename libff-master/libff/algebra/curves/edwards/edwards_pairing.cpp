@@ -719,6 +719,57 @@ edwards_Fq6 edwards_ate_double_miller_loop(const edwards_ate_G1_precomp &prec_P1
     return f;
 }
 
+edwards_Fq6 edwards_ate_multi_miller_loop(const std::vector<edwards_ate_G1_precomp> &prec_P,
+                                          const std::vector<edwards_ate_G2_precomp> &prec_Q)
+{
+    enter_block("Call to edwards_ate_multi_miller_loop");
+    assert(prec_P.size() == prec_Q.size());
+    const bigint<edwards_Fr::num_limbs> &loop_count = edwards_ate_loop_count;
+
+    edwards_Fq6 f = edwards_Fq6::one();
+
+    bool found_one = false;
+    size_t idx = 0;
+    for (long i = loop_count.max_bits()-1; i >= 0; --i)
+    {
+        const bool bit = loop_count.test_bit(i);
+        if (!found_one)
+        {
+            /* this skips the MSB itself */
+            found_one |= bit;
+            continue;
+        }
+
+        /* code below gets executed for all bits (EXCEPT the MSB itself) of
+           edwards_param_p (skipping leading zeros) in MSB to LSB
+           order; the squaring of f is shared by all pairs */
+        f = f.squared();
+        for (size_t j = 0; j < prec_P.size(); ++j)
+        {
+            const edwards_Fq3_conic_coefficients &cc = prec_Q[j][idx];
+            const edwards_Fq6 g_RR_at_P = edwards_Fq6(prec_P[j].P_XY * cc.c_XY + prec_P[j].P_XZ * cc.c_XZ,
+                                                      prec_P[j].P_ZZplusYZ * cc.c_ZZ);
+            f = f * g_RR_at_P;
+        }
+        ++idx;
+
+        if (bit)
+        {
+            for (size_t j = 0; j < prec_P.size(); ++j)
+            {
+                const edwards_Fq3_conic_coefficients &cc = prec_Q[j][idx];
+                const edwards_Fq6 g_RQ_at_P = edwards_Fq6(prec_P[j].P_ZZplusYZ * cc.c_ZZ,
+                                                          prec_P[j].P_XY * cc.c_XY + prec_P[j].P_XZ * cc.c_XZ);
+                f = f * g_RQ_at_P;
+            }
+            ++idx;
+        }
+    }
+    leave_block("Call to edwards_ate_multi_miller_loop");
+
+    return f;
+}
+
 edwards_Fq6 edwards_ate_pairing(const edwards_G1& P, const edwards_G2 &Q)
 {
     enter_block("Call to edwards_ate_pairing");
@@ -762,6 +813,12 @@ edwards_Fq6 edwards_double_miller_loop(const edwards_G1_precomp &prec_P1,
     return edwards_ate_double_miller_loop(prec_P1, prec_Q1, prec_P2, prec_Q2);
 }
 
+edwards_Fq6 edwards_multi_miller_loop(const std::vector<edwards_G1_precomp> &prec_P,
+                                      const std::vector<edwards_G2_precomp> &prec_Q)
+{
+    return edwards_ate_multi_miller_loop(prec_P, prec_Q);
+}
+
 edwards_Fq6 edwards_pairing(const edwards_G1& P,
                             const edwards_G2 &Q)
 {
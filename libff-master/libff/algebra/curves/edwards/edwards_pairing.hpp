@@ -91,6 +91,8 @@ edwards_Fq6 edwards_ate_double_miller_loop(const edwards_ate_G1_precomp &prec_P1
                                            const edwards_ate_G2_precomp &prec_Q1,
                                            const edwards_ate_G1_precomp &prec_P2,
                                            const edwards_ate_G2_precomp &prec_Q2);
+edwards_Fq6 edwards_ate_multi_miller_loop(const std::vector<edwards_ate_G1_precomp> &prec_P,
+                                          const std::vector<edwards_ate_G2_precomp> &prec_Q);
 
 edwards_Fq6 edwards_ate_pairing(const edwards_G1& P,
                                 const edwards_G2 &Q);
@@ -113,6 +115,9 @@ edwards_Fq6 edwards_double_miller_loop(const edwards_G1_precomp &prec_P1,
                                        const edwards_G1_precomp &prec_P2,
                                        const edwards_G2_precomp &prec_Q2);
 
+edwards_Fq6 edwards_multi_miller_loop(const std::vector<edwards_G1_precomp> &prec_P,
+                                      const std::vector<edwards_G2_precomp> &prec_Q);
+
 edwards_Fq6 edwards_pairing(const edwards_G1& P,
                             const edwards_G2 &Q);
 
@@ -43,6 +43,12 @@ edwards_Fq6 edwards_pp::double_miller_loop(const edwards_G1_precomp &prec_P1,
     return edwards_double_miller_loop(prec_P1, prec_Q1, prec_P2, prec_Q2);
 }
 
+edwards_Fq6 edwards_pp::multi_miller_loop(const std::vector<edwards_G1_precomp> &prec_P,
+                                          const std::vector<edwards_G2_precomp> &prec_Q)
+{
+    return edwards_multi_miller_loop(prec_P, prec_Q);
+}
+
 edwards_Fq6 edwards_pp::pairing(const edwards_G1 &P,
                                 const edwards_G2 &Q)
 {
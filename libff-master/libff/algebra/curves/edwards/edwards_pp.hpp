@@ -39,6 +39,8 @@ public:
                                           const edwards_G2_precomp &prec_Q1,
                                           const edwards_G1_precomp &prec_P2,
                                           const edwards_G2_precomp &prec_Q2);
+    static edwards_Fq6 multi_miller_loop(const std::vector<edwards_G1_precomp> &prec_P,
+                                         const std::vector<edwards_G2_precomp> &prec_Q);
     /* the following are used in test files */
     static edwards_Fq6 pairing(const edwards_G1 &P,
                                const edwards_G2 &Q);
@@ -59,6 +59,7 @@ void init_mnt4_params()
         mnt4_Fr::Rcubed = bigint_r("207236281459091063710247635236340312578688659363066707916716212805695955118593239854980171");
         mnt4_Fr::inv = 0xffffffff;
     }
+    mnt4_Fr::init_jit();
     mnt4_Fr::num_bits = 298;
     mnt4_Fr::euler = bigint_r("237961143084630662876674624826524225772562439276411757776633867869582323653704245279981568");
     mnt4_Fr::s = 34;
@@ -84,6 +85,7 @@ void init_mnt4_params()
         mnt4_Fq::Rcubed = bigint_q("427298980065529822574935274648041073124704261331681436071990730954930769758106792920349077");
         mnt4_Fq::inv = 0x7165ffff;
     }
+    mnt4_Fq::init_jit();
     mnt4_Fq::num_bits = 298;
     mnt4_Fq::euler = bigint_q("237961143084630662876674624826524225772562439621347362697777564288105131408977900241879040");
     mnt4_Fq::s = 17;
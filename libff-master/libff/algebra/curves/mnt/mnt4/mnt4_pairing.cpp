@@ -673,6 +673,81 @@ mnt4_Fq4 mnt4_ate_double_miller_loop(const mnt4_ate_G1_precomp &prec_P1,
     return f;
 }
 
+mnt4_Fq4 mnt4_ate_multi_miller_loop(const std::vector<mnt4_ate_G1_precomp> &prec_P,
+                                    const std::vector<mnt4_ate_G2_precomp> &prec_Q)
+{
+    enter_block("Call to mnt4_ate_multi_miller_loop");
+    assert(prec_P.size() == prec_Q.size());
+
+    std::vector<mnt4_Fq2> L1_coeff;
+    L1_coeff.reserve(prec_P.size());
+    for (size_t j = 0; j < prec_P.size(); ++j)
+    {
+        L1_coeff.emplace_back(mnt4_Fq2(prec_P[j].PX, mnt4_Fq::zero()) - prec_Q[j].QX_over_twist);
+    }
+
+    mnt4_Fq4 f = mnt4_Fq4::one();
+
+    bool found_one = false;
+    size_t dbl_idx = 0;
+    size_t add_idx = 0;
+
+    const bigint<mnt4_Fr::num_limbs> &loop_count = mnt4_ate_loop_count;
+    for (long i = loop_count.max_bits() - 1; i >= 0; --i)
+    {
+        const bool bit = loop_count.test_bit(i);
+
+        if (!found_one)
+        {
+            /* this skips the MSB itself */
+            found_one |= bit;
+            continue;
+        }
+
+        /* code below gets executed for all bits (EXCEPT the MSB itself) of
+           mnt4_param_p (skipping leading zeros) in MSB to LSB
+           order; the squaring of f is shared by all pairs */
+        f = f.squared();
+        for (size_t j = 0; j < prec_P.size(); ++j)
+        {
+            const mnt4_ate_dbl_coeffs &dc = prec_Q[j].dbl_coeffs[dbl_idx];
+            const mnt4_Fq4 g_RR_at_P = mnt4_Fq4(- dc.c_4C - dc.c_J * prec_P[j].PX_twist + dc.c_L,
+                                              dc.c_H * prec_P[j].PY_twist);
+            f = f * g_RR_at_P;
+        }
+        ++dbl_idx;
+
+        if (bit)
+        {
+            for (size_t j = 0; j < prec_P.size(); ++j)
+            {
+                const mnt4_ate_add_coeffs &ac = prec_Q[j].add_coeffs[add_idx];
+                const mnt4_Fq4 g_RQ_at_P = mnt4_Fq4(ac.c_RZ * prec_P[j].PY_twist,
+                                                  -(prec_Q[j].QY_over_twist * ac.c_RZ + L1_coeff[j] * ac.c_L1));
+                f = f * g_RQ_at_P;
+            }
+            ++add_idx;
+        }
+    }
+
+    if (mnt4_ate_is_loop_count_neg)
+    {
+        for (size_t j = 0; j < prec_P.size(); ++j)
+        {
+            const mnt4_ate_add_coeffs &ac = prec_Q[j].add_coeffs[add_idx];
+            const mnt4_Fq4 g_RnegR_at_P = mnt4_Fq4(ac.c_RZ * prec_P[j].PY_twist,
+                                                 -(prec_Q[j].QY_over_twist * ac.c_RZ + L1_coeff[j] * ac.c_L1));
+            f = f * g_RnegR_at_P;
+        }
+        ++add_idx;
+        f = f.inverse();
+    }
+
+    leave_block("Call to mnt4_ate_multi_miller_loop");
+
+    return f;
+}
+
 mnt4_Fq4 mnt4_ate_pairing(const mnt4_G1& P, const mnt4_G2 &Q)
 {
     enter_block("Call to mnt4_ate_pairing");
@@ -716,6 +791,12 @@ mnt4_Fq4 mnt4_double_miller_loop(const mnt4_G1_precomp &prec_P1,
     return mnt4_ate_double_miller_loop(prec_P1, prec_Q1, prec_P2, prec_Q2);
 }
 
+mnt4_Fq4 mnt4_multi_miller_loop(const std::vector<mnt4_G1_precomp> &prec_P,
+                                const std::vector<mnt4_G2_precomp> &prec_Q)
+{
+    return mnt4_ate_multi_miller_loop(prec_P, prec_Q);
+}
+
 mnt4_Fq4 mnt4_pairing(const mnt4_G1& P,
                       const mnt4_G2 &Q)
 {
@@ -111,6 +111,8 @@ mnt4_Fq4 mnt4_ate_double_miller_loop(const mnt4_ate_G1_precomp &prec_P1,
                                            const mnt4_ate_G2_precomp &prec_Q1,
                                            const mnt4_ate_G1_precomp &prec_P2,
                                            const mnt4_ate_G2_precomp &prec_Q2);
+mnt4_Fq4 mnt4_ate_multi_miller_loop(const std::vector<mnt4_ate_G1_precomp> &prec_P,
+                                    const std::vector<mnt4_ate_G2_precomp> &prec_Q);
 
 mnt4_Fq4 mnt4_ate_pairing(const mnt4_G1& P,
                           const mnt4_G2 &Q);
@@ -134,6 +136,9 @@ mnt4_Fq4 mnt4_double_miller_loop(const mnt4_G1_precomp &prec_P1,
                                  const mnt4_G1_precomp &prec_P2,
                                  const mnt4_G2_precomp &prec_Q2);
 
+mnt4_Fq4 mnt4_multi_miller_loop(const std::vector<mnt4_G1_precomp> &prec_P,
+                                const std::vector<mnt4_G2_precomp> &prec_Q);
+
 mnt4_Fq4 mnt4_pairing(const mnt4_G1& P,
                       const mnt4_G2 &Q);
 
@@ -65,6 +65,8 @@ public:
                                        const mnt4_G2_precomp &prec_Q1,
                                        const mnt4_G1_precomp &prec_P2,
                                        const mnt4_G2_precomp &prec_Q2);
+    static mnt4_Fq4 multi_miller_loop(const std::vector<mnt4_G1_precomp> &prec_P,
+                                      const std::vector<mnt4_G2_precomp> &prec_Q);
 
     /* the following are used in test files */
     static mnt4_Fq4 pairing(const mnt4_G1 &P,
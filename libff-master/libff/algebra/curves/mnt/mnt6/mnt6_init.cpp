@@ -61,6 +61,7 @@ void init_mnt6_params()
         mnt6_Fr::Rcubed = bigint_r("427298980065529822574935274648041073124704261331681436071990730954930769758106792920349077");
         mnt6_Fr::inv = 0x7165ffff;
     }
+    mnt6_Fr::init_jit();
     mnt6_Fr::num_bits = 298;
     mnt6_Fr::euler = bigint_r("237961143084630662876674624826524225772562439621347362697777564288105131408977900241879040");
     mnt6_Fr::s = 17;
@@ -86,6 +87,7 @@ void init_mnt6_params()
         mnt6_Fq::Rcubed = bigint_q("207236281459091063710247635236340312578688659363066707916716212805695955118593239854980171");
         mnt6_Fq::inv = 0xffffffff;
     }
+    mnt6_Fq::init_jit();
     mnt6_Fq::num_bits = 298;
     mnt6_Fq::euler = bigint_q("237961143084630662876674624826524225772562439276411757776633867869582323653704245279981568");
     mnt6_Fq::s = 34;
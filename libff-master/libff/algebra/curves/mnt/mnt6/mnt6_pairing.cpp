@@ -685,6 +685,81 @@ mnt6_Fq6 mnt6_ate_double_miller_loop(const mnt6_ate_G1_precomp &prec_P1,
     return f;
 }
 
+mnt6_Fq6 mnt6_ate_multi_miller_loop(const std::vector<mnt6_ate_G1_precomp> &prec_P,
+                                    const std::vector<mnt6_ate_G2_precomp> &prec_Q)
+{
+    enter_block("Call to mnt6_ate_multi_miller_loop");
+    assert(prec_P.size() == prec_Q.size());
+
+    std::vector<mnt6_Fq3> L1_coeff;
+    L1_coeff.reserve(prec_P.size());
+    for (size_t j = 0; j < prec_P.size(); ++j)
+    {
+        L1_coeff.emplace_back(mnt6_Fq3(prec_P[j].PX, mnt6_Fq::zero(), mnt6_Fq::zero()) - prec_Q[j].QX_over_twist);
+    }
+
+    mnt6_Fq6 f = mnt6_Fq6::one();
+
+    bool found_one = false;
+    size_t dbl_idx = 0;
+    size_t add_idx = 0;
+
+    const bigint<mnt6_Fr::num_limbs> &loop_count = mnt6_ate_loop_count;
+    for (long i = loop_count.max_bits() - 1; i >= 0; --i)
+    {
+        const bool bit = loop_count.test_bit(i);
+
+        if (!found_one)
+        {
+            /* this skips the MSB itself */
+            found_one |= bit;
+            continue;
+        }
+
+        /* code below gets executed for all bits (EXCEPT the MSB itself) of
+           mnt6_param_p (skipping leading zeros) in MSB to LSB
+           order; the squaring of f is shared by all pairs */
+        f = f.squared();
+        for (size_t j = 0; j < prec_P.size(); ++j)
+        {
+            const mnt6_ate_dbl_coeffs &dc = prec_Q[j].dbl_coeffs[dbl_idx];
+            const mnt6_Fq6 g_RR_at_P = mnt6_Fq6(- dc.c_4C - dc.c_J * prec_P[j].PX_twist + dc.c_L,
+                                              dc.c_H * prec_P[j].PY_twist);
+            f = f * g_RR_at_P;
+        }
+        ++dbl_idx;
+
+        if (bit)
+        {
+            for (size_t j = 0; j < prec_P.size(); ++j)
+            {
+                const mnt6_ate_add_coeffs &ac = prec_Q[j].add_coeffs[add_idx];
+                const mnt6_Fq6 g_RQ_at_P = mnt6_Fq6(ac.c_RZ * prec_P[j].PY_twist,
+                                                  -(prec_Q[j].QY_over_twist * ac.c_RZ + L1_coeff[j] * ac.c_L1));
+                f = f * g_RQ_at_P;
+            }
+            ++add_idx;
+        }
+    }
+
+    if (mnt6_ate_is_loop_count_neg)
+    {
+        for (size_t j = 0; j < prec_P.size(); ++j)
+        {
+            const mnt6_ate_add_coeffs &ac = prec_Q[j].add_coeffs[add_idx];
+            const mnt6_Fq6 g_RnegR_at_P = mnt6_Fq6(ac.c_RZ * prec_P[j].PY_twist,
+                                                 -(prec_Q[j].QY_over_twist * ac.c_RZ + L1_coeff[j] * ac.c_L1));
+            f = f * g_RnegR_at_P;
+        }
+        ++add_idx;
+        f = f.inverse();
+    }
+
+    leave_block("Call to mnt6_ate_multi_miller_loop");
+
+    return f;
+}
+
 mnt6_Fq6 mnt6_ate_pairing(const mnt6_G1& P, const mnt6_G2 &Q)
 {
     enter_block("Call to mnt6_ate_pairing");
@@ -728,6 +803,12 @@ mnt6_Fq6 mnt6_double_miller_loop(const mnt6_G1_precomp &prec_P1,
     return mnt6_ate_double_miller_loop(prec_P1, prec_Q1, prec_P2, prec_Q2);
 }
 
+mnt6_Fq6 mnt6_multi_miller_loop(const std::vector<mnt6_G1_precomp> &prec_P,
+                                const std::vector<mnt6_G2_precomp> &prec_Q)
+{
+    return mnt6_ate_multi_miller_loop(prec_P, prec_Q);
+}
+
 mnt6_Fq6 mnt6_pairing(const mnt6_G1& P,
                       const mnt6_G2 &Q)
 {
@@ -111,6 +111,8 @@ mnt6_Fq6 mnt6_ate_double_miller_loop(const mnt6_ate_G1_precomp &prec_P1,
                                      const mnt6_ate_G2_precomp &prec_Q1,
                                      const mnt6_ate_G1_precomp &prec_P2,
                                      const mnt6_ate_G2_precomp &prec_Q2);
+mnt6_Fq6 mnt6_ate_multi_miller_loop(const std::vector<mnt6_ate_G1_precomp> &prec_P,
+                                    const std::vector<mnt6_ate_G2_precomp> &prec_Q);
 
 mnt6_Fq6 mnt6_ate_pairing(const mnt6_G1& P,
                           const mnt6_G2 &Q);
@@ -134,6 +136,9 @@ mnt6_Fq6 mnt6_double_miller_loop(const mnt6_G1_precomp &prec_P1,
                                  const mnt6_G1_precomp &prec_P2,
                                  const mnt6_G2_precomp &prec_Q2);
 
+mnt6_Fq6 mnt6_multi_miller_loop(const std::vector<mnt6_G1_precomp> &prec_P,
+                                const std::vector<mnt6_G2_precomp> &prec_Q);
+
 mnt6_Fq6 mnt6_pairing(const mnt6_G1& P,
                       const mnt6_G2 &Q);
 
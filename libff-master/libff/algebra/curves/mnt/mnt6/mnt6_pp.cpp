@@ -66,6 +66,12 @@ mnt6_Fq6 mnt6_pp::double_miller_loop(const mnt6_G1_precomp &prec_P1,
     return mnt6_double_miller_loop(prec_P1, prec_Q1, prec_P2, prec_Q2);
 }
 
+mnt6_Fq6 mnt6_pp::multi_miller_loop(const std::vector<mnt6_G1_precomp> &prec_P,
+                                    const std::vector<mnt6_G2_precomp> &prec_Q)
+{
+    return mnt6_multi_miller_loop(prec_P, prec_Q);
+}
+
 mnt6_Fq6 mnt6_pp::affine_ate_e_over_e_miller_loop(const mnt6_affine_ate_G1_precomputation &prec_P1,
                                                   const mnt6_affine_ate_G2_precomputation &prec_Q1,
                                                   const mnt6_affine_ate_G1_precomputation &prec_P2,
@@ -60,6 +60,8 @@ public:
                                        const mnt6_G2_precomp &prec_Q1,
                                        const mnt6_G1_precomp &prec_P2,
                                        const mnt6_G2_precomp &prec_Q2);
+    static mnt6_Fq6 multi_miller_loop(const std::vector<mnt6_G1_precomp> &prec_P,
+                                      const std::vector<mnt6_G2_precomp> &prec_Q);
 
     /* the following are used in test files */
     static mnt6_Fq6 pairing(const mnt6_G1 &P,
@@ -8,17 +8,27 @@
 #include <libff/algebra/curves/alt_bn128/alt_bn128_pp.hpp>
 #include <libff/algebra/curves/mnt/mnt4/mnt4_pp.hpp>
 #include <libff/algebra/curves/mnt/mnt6/mnt6_pp.hpp>
+#include <libff/algebra/scalar_multiplication/multiexp.hpp>
 
 #include <chrono>
+#include <fcntl.h>
 #include <fstream>
 #include <iostream>
 #include <jsoncpp/json/json.h>
+#include <openssl/sha.h>
 #include <stdlib.h>
 #include <string>
+#include <sys/mman.h>
 #include <unistd.h>
 
 #define PATH_DIR "results/"
 #define DEBUG false
+// compile with -DLEGACY_HASH_TO_G1 for H(name, i) = (name * i) * g1, which is
+// what solidity/contracts/Compact.sol still computes, until it moves to the hash
+// domain separation tag of H, the hash of (name, i) to G1
+#define HASH_DST "COMPACT-POR-V01-CS01-with-BN254G1_XMD:SHA-256_SVDW_RO_"
+// number of indices hashed together by signing()
+#define HASH_BATCH 1024
 
 using namespace std::chrono;
 using namespace libff;
@@ -116,6 +126,7 @@ Fr<ppT> readFr(string path)
 
 /**
  * Read data, a G1 point, in the file specifies in path
+ * Throw an exception if the point is not in G1
  * @param path file where the data is written
  * @return G1 point stored in file 
  */
@@ -135,12 +146,18 @@ G1<ppT> readG1(string path)
     }
 
     is_file.close();
-    return alt_bn128_G1(X, Y, Z);
+
+    const alt_bn128_G1 P(X, Y, Z);
+    if (!P.is_in_subgroup()) {
+        throw ifstream::failure("Point in " + path + " is not in G1");
+    }
+    return P;
 }
 
 /**
  * Read data, a G1 point, in the file specifies in path at a certain spot
  * of the file specifies by position
+ * Throw an exception if the point is not in G1
  * @param path file where the data is written
  * @param position spot where the data to read is stored
  * @return G1 point stored in file at the position <position>
@@ -162,11 +179,55 @@ G1<ppT> readG1Pos(string path, unsigned long long int position)
     }
     
     is_file.close();
-    return alt_bn128_G1(X, Y, Z);
+
+    const alt_bn128_G1 P(X, Y, Z);
+    if (!P.is_in_subgroup()) {
+        throw ifstream::failure("Point in " + path + " is not in G1");
+    }
+    return P;
+}
+
+/**
+ * Map the first count G1 points of the file specifies in path into memory,
+ * read-only, so that they can be used in place
+ * Throw an exception if the file can NOT be mapped or a point is not in G1
+ * @param path file where the data is written
+ * @param count number of points to map
+ * @return the count G1 points stored in file, to release with munmap
+ */
+template<typename ppT>
+const G1<ppT>* mapG1(string path, unsigned long long int count)
+{
+    static_assert(sizeof(G1<ppT>) == 3 * sizeof(alt_bn128_Fq), "G1 points are stored as X, Y, Z");
+    const size_t length = count * sizeof(G1<ppT>);
+
+    if (getSize(PATH_DIR + path) < length) {
+        throw ifstream::failure("File " + path + " holds less than " + to_string(count) + " points");
+    }
+
+    const int fd = open((PATH_DIR + path).c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw ifstream::failure("File " + path + " not found");
+    }
+    void *data = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        throw ifstream::failure("File " + path + " can not be mapped");
+    }
+
+    const G1<ppT> *points = (const G1<ppT>*) data;
+    for (unsigned long long int j = 0; j < count; j++) {
+        if (!points[j].is_in_subgroup()) {
+            munmap(data, length);
+            throw ifstream::failure("Point in " + path + " is not in G1");
+        }
+    }
+    return points;
 }
 
 /**
  * Read data, a G2 point, in the file specifies in path
+ * Throw an exception if the point is not in G2
  * @param path file where the data is written
  * @return G2 point stored in file 
  */
@@ -186,7 +247,12 @@ G2<ppT> readG2(string path)
     }
 
     is_file.close();
-    return alt_bn128_G2(X, Y, Z);
+
+    const alt_bn128_G2 P(X, Y, Z);
+    if (!P.is_in_subgroup()) {
+        throw ifstream::failure("Point in " + path + " is not in G2");
+    }
+    return P;
 }
 
 /**
@@ -259,6 +325,144 @@ void writeG2(string path, G2<ppT> data)
     os_file.close();
 }
 
+/**
+ * expand_message_xmd of RFC 9380 (section 5.3.1), with SHA-256 and HASH_DST
+ * @param msg message to expand
+ * @param len number of bytes to output, at most 255 * 32
+ * @return len pseudorandom bytes
+ */
+vector<unsigned char> expandMessageXmd(const vector<unsigned char> &msg, size_t len)
+{
+    const string dst = HASH_DST;
+    vector<unsigned char> dst_prime(dst.begin(), dst.end());
+    dst_prime.push_back((unsigned char) dst.size());
+
+    // b_0 = H(Z_pad || msg || I2OSP(len, 2) || I2OSP(0, 1) || DST_prime)
+    vector<unsigned char> msg_prime(SHA256_CBLOCK, 0);
+    msg_prime.insert(msg_prime.end(), msg.begin(), msg.end());
+    msg_prime.push_back((unsigned char) (len >> 8));
+    msg_prime.push_back((unsigned char) len);
+    msg_prime.push_back(0);
+    msg_prime.insert(msg_prime.end(), dst_prime.begin(), dst_prime.end());
+
+    unsigned char b_0[SHA256_DIGEST_LENGTH], b_i[SHA256_DIGEST_LENGTH];
+    SHA256(msg_prime.data(), msg_prime.size(), b_0);
+
+    // b_i = H(strxor(b_0, b_(i-1)) || I2OSP(i, 1) || DST_prime), with b_1 = H(b_0 || ...)
+    vector<unsigned char> uniform_bytes;
+    vector<unsigned char> block(SHA256_DIGEST_LENGTH + 1 + dst_prime.size());
+    std::copy(dst_prime.begin(), dst_prime.end(), block.begin() + SHA256_DIGEST_LENGTH + 1);
+    for (size_t i = 1; uniform_bytes.size() < len; i++) {
+        for (size_t j = 0; j < SHA256_DIGEST_LENGTH; j++) {
+            block[j] = (i == 1 ? b_0[j] : b_0[j] ^ b_i[j]);
+        }
+        block[SHA256_DIGEST_LENGTH] = (unsigned char) i;
+        SHA256(block.data(), block.size(), b_i);
+        uniform_bytes.insert(uniform_bytes.end(), b_i, b_i + SHA256_DIGEST_LENGTH);
+    }
+
+    uniform_bytes.resize(len);
+    return uniform_bytes;
+}
+
+/**
+ * hash_to_field of RFC 9380 (section 5.2) for (name, i), giving the two
+ * elements of Fq that H maps to G1
+ * @param name file identifier
+ * @param i index of the chunk
+ * @param u0 first field element
+ * @param u1 second field element
+ */
+template<typename ppT>
+void hashToField(Fr<ppT> name, unsigned long long int i, alt_bn128_Fq &u0, alt_bn128_Fq &u1)
+{
+    // 48 bytes per element, for 128 bits of security above the 254 bits of q
+    const size_t L = 48;
+
+    // msg = name (32 bytes) || i (8 bytes), both big-endian
+    vector<unsigned char> msg(40);
+    const bigint<alt_bn128_r_limbs> name_bigint = name.as_bigint();
+    for (size_t j = 0; j < 32; j++) {
+        msg[31 - j] = (unsigned char) (name_bigint.data[j / sizeof(mp_limb_t)] >> (8 * (j % sizeof(mp_limb_t))));
+    }
+    for (size_t j = 0; j < 8; j++) {
+        msg[39 - j] = (unsigned char) (i >> (8 * j));
+    }
+
+    const vector<unsigned char> uniform_bytes = expandMessageXmd(msg, 2 * L);
+
+    mpz_t t, q;
+    mpz_init(t);
+    mpz_init(q);
+    alt_bn128_modulus_q.to_mpz(q);
+
+    mpz_import(t, L, 1, 1, 1, 0, uniform_bytes.data());
+    mpz_mod(t, t, q);
+    u0 = alt_bn128_Fq(bigint<alt_bn128_q_limbs>(t));
+
+    mpz_import(t, L, 1, 1, 1, 0, uniform_bytes.data() + L);
+    mpz_mod(t, t, q);
+    u1 = alt_bn128_Fq(bigint<alt_bn128_q_limbs>(t));
+
+    mpz_clear(q);
+    mpz_clear(t);
+}
+
+/**
+ * H(name, i) for every i in indices, with one field inversion in total.
+ * H is a random oracle to G1 (hash_to_curve of RFC 9380 with the
+ * Shallue--van de Woestijne map), used in place of name * i * g1
+ * (or (name * i) * g1 with LEGACY_HASH_TO_G1)
+ * @param name file identifier
+ * @param indices indices of the chunks
+ * @return H(name, indices[j]) for every j
+ */
+template<typename ppT>
+vector<G1<ppT>> batchHashToG1(Fr<ppT> name, const vector<unsigned long long int> &indices)
+{
+#ifdef LEGACY_HASH_TO_G1
+    vector<G1<ppT>> legacy;
+    legacy.reserve(indices.size());
+    for (size_t j = 0; j < indices.size(); j++) {
+        legacy.emplace_back((Fr<ppT>(indices[j]) * name) * G1<ppT>::one());
+    }
+    return legacy;
+#else
+    vector<alt_bn128_Fq> u(2 * indices.size());
+    for (size_t j = 0; j < indices.size(); j++) {
+        hashToField<ppT>(name, indices[j], u[2 * j], u[2 * j + 1]);
+    }
+
+    const vector<alt_bn128_G1> points = alt_bn128_G1::batch_map_to_curve(u);
+    vector<G1<ppT>> result;
+    result.reserve(indices.size());
+    for (size_t j = 0; j < indices.size(); j++) {
+        // both points are affine
+        result.emplace_back(points[2 * j].mixed_add(points[2 * j + 1]));
+    }
+
+    return result;
+#endif
+}
+
+/**
+ * Converts P to affine coordinates with a constant-time inversion, for
+ * points whose projective coordinates depend on a secret
+ * @param P point to convert
+ */
+template<typename ppT>
+void toAffineCt(G1<ppT> &P)
+{
+    if (P.is_zero()) {
+        return;
+    }
+    const alt_bn128_Fq Z_inv = P.Z.inverse_ct();
+    const alt_bn128_Fq Z2_inv = Z_inv.squared();
+    P.X = P.X * Z2_inv;
+    P.Y = P.Y * Z2_inv * Z_inv;
+    P.Z = alt_bn128_Fq::one();
+}
+
 /**
  * Initialize all necessary metadata to run the protocol of Proof of
  * Retrievability :
@@ -296,8 +500,15 @@ int initialization(unsigned long long int s)
         u_path = "u.bin";
         os_u = safeOpenOut(PATH_DIR + u_path);
 
+        vector<Fr<ppT>> r(s);
         for(unsigned long long int j = 0; j < s; j++) {
-            u = Fr<ppT>::random_element() * g1;
+            r[j] = Fr<ppT>::random_element();
+        }
+        // Z = 1, as multi-exponentiations with mixed addition expect
+        const vector<G1<ppT>> us = batch_exp_to_special<G1<ppT>, Fr<ppT>>(Fr<ppT>::size_in_bits(), g1, r);
+
+        for(unsigned long long int j = 0; j < s; j++) {
+            u = us[j];
             os_u.write((char*) &u.X, sizeof(alt_bn128_Fq));
             os_u.write((char*) &u.Y, sizeof(alt_bn128_Fq));
             os_u.write((char*) &u.Z, sizeof(alt_bn128_Fq));
@@ -329,16 +540,20 @@ int signing(string filePath, unsigned long long int s)
 
     G1<ppT> g1 = G1<ppT>::one(),
             res = g1,
-            u,
             u_m;
 
+    const G1<ppT> *u = NULL;
+
     G2<ppT> g2 = G2<ppT>::one();
     
     int i = 0;
-    unsigned int m = 0;
-    unsigned long long int loop = 0;
+    unsigned long long int loop = 0,
+                           nb_chunks = 0;
 
-    bool stop = false;
+    vector<unsigned char> chunk(s);
+    vector<Fr<ppT>> m(s);
+    vector<unsigned long long int> indices;
+    vector<G1<ppT>> h;
 
     ifstream is_to_sign;
     ofstream os_signature;
@@ -347,25 +562,36 @@ int signing(string filePath, unsigned long long int s)
         sk = readFr<ppT>("sk.bin");
         name = readFr<ppT>("name.bin");
         is_to_sign = safeOpenIn(filePath);
+        is_to_sign.seekg(0, is_to_sign.end);
+        nb_chunks = (unsigned long long int) is_to_sign.tellg() / s;
         is_to_sign.seekg(0, is_to_sign.beg);
         os_signature = safeOpenOut("results/signature.bin");
+        u = mapG1<ppT>("u.bin", s);
 
         while (true) { // size / s
-            u_m = G1<ppT>::zero();
+            // a last incomplete chunk is not signed
+            is_to_sign.read((char*) chunk.data(), s);
+            if ((unsigned long long int) is_to_sign.gcount() < s) break;
 
-            for(unsigned long long j = 0; j < s; j++) {
-                is_to_sign.read((char*)&m, 1);
-                if (is_to_sign.eof()) {
-                    stop = true;
-                    break;
+            // u_m = sum of m_j * u_j, over the points of u.bin in place
+            for (unsigned long long int j = 0; j < s; j++) {
+                m[j] = Fr<ppT>(chunk[j]);
+            }
+            u_m = multi_exp<G1<ppT>, Fr<ppT>, multi_exp_method_pippenger_signed>(
+                u, sizeof(G1<ppT>), m.data(), sizeof(Fr<ppT>), s, 1);
+
+            // H(name, loop), hashed HASH_BATCH chunks at a time
+            if (loop % HASH_BATCH == 0) {
+                indices.clear();
+                for (unsigned long long int j = loop; j < nb_chunks && j < loop + HASH_BATCH; j++) {
+                    indices.push_back(j);
                 }
-
-                u = readG1Pos<ppT>("u.bin", j);
-                u_m = u_m + (Fr<ppT>(m) * u);
+                h = batchHashToG1<ppT>(name, indices);
             }
 
-            if (stop) break;
-            res = sk * (((Fr<ppT>(loop) * name) * g1) + u_m);
+            res = sk * (h[loop % HASH_BATCH] + u_m);
+            // the projective Z of res depends on sk, so it is not written out
+            toAffineCt<ppT>(res);
 
             if(DEBUG) {cout << "signature : "; res.print();}
             os_signature.write((char*)&res.X, sizeof(alt_bn128_Fq));
@@ -381,6 +607,7 @@ int signing(string filePath, unsigned long long int s)
         throw std::exception();
     }
 
+    munmap((void*) u, s * sizeof(G1<ppT>));
     os_signature.close();
     is_to_sign.close();
     return 0;
@@ -500,20 +727,16 @@ bool verifying(unsigned int c, unsigned long long int s)
 {
     Fr<ppT> name;
 
-    G1<ppT> g1 = G1<ppT>::one(),
-            u,
-            res_u,
+    G1<ppT> res_u,
             sigma,
             res_h,
             res_right;
+
+    const G1<ppT> *u = NULL;
             
     G2<ppT> g2 = G2<ppT>::one(),
             pk;
 
-    GT<ppT> part1, part2;
-
-    unsigned long long int i = 1;
-    unsigned int nu = 1;
     unsigned int mu = 0;
 
     ifstream is_challenge, is_mu;
@@ -526,35 +749,44 @@ bool verifying(unsigned int c, unsigned long long int s)
         name = readFr<ppT>("name.bin");
         pk = readG2<ppT>("pk.bin");
 
-        // First part to computre
-        part1 = ppT::reduced_pairing(sigma, g2);
-        
-        // Second part
+        // Right-hand side: sum of mu_j * u_j and nu * H(name, i), as
+        // multi-exponentiations sized for these small scalars
         is_mu = safeOpenIn("results/mu.bin");
+        vector<Fr<ppT>> mus(s);
         for (uint j = 0; j < s; j++) {
-            u = readG1Pos<ppT>("u.bin", j);
             is_mu.read((char*)&mu, sizeof(unsigned int));
-            res_u = res_u + (Fr<ppT>(mu) * u);
+            mus[j] = Fr<ppT>(mu);
         }
 
         is_mu.close();
 
+        u = mapG1<ppT>("u.bin", s);
+        res_u = multi_exp<G1<ppT>, Fr<ppT>, multi_exp_method_auto>(
+            u, sizeof(G1<ppT>), mus.data(), sizeof(Fr<ppT>), s, 1);
+        munmap((void*) u, s * sizeof(G1<ppT>));
+
         is_challenge = safeOpenIn("results/challenge.bin");
         is_challenge.seekg(0, is_challenge.beg);
 
-        res_h = G1<ppT>::zero();
+        vector<unsigned long long int> indices(c);
+        vector<unsigned int> nus(c);
         for (uint nb = 0; nb < c; nb++) {
-            is_challenge.read((char*) &i, sizeof(unsigned long long int));
-            is_challenge.read((char*) &nu, sizeof(unsigned int));
-            res_h = res_h + (Fr<ppT>(nu) * (Fr<ppT>(name * i) * g1));
+            is_challenge.read((char*) &indices[nb], sizeof(unsigned long long int));
+            is_challenge.read((char*) &nus[nb], sizeof(unsigned int));
         }
 
         is_challenge.close();
 
+        vector<G1<ppT>> h = batchHashToG1<ppT>(name, indices);
+        batch_to_special(h);
+        vector<Fr<ppT>> nus_fr(nus.begin(), nus.end());
+        res_h = multi_exp<G1<ppT>, Fr<ppT>, multi_exp_method_auto>(
+            h.cbegin(), h.cend(), nus_fr.cbegin(), nus_fr.cend(), 1);
+
         res_right = res_h + res_u;
-        part2 = ppT::reduced_pairing(res_right, pk);
 
-        return part1 == part2;
+        // e(sigma, g2) == e(res_right, pk), as e(sigma, g2) * e(-res_right, pk) == 1
+        return pairing_product_is_one<ppT>({sigma, -res_right}, {g2, pk});
 
     } catch(const ios_base::failure& ios_e) {
         throw ios_base::failure(ios_e);
@@ -565,7 +797,7 @@ bool verifying(unsigned int c, unsigned long long int s)
 }
 
 
-// To compile: g++ -o compact compact.cpp -I ~/.local/include/ -L ~/.local/lib/ -lff -lgmp -ljsoncpp
+// To compile: g++ -o compact compact.cpp -I ~/.local/include/ -L ~/.local/lib/ -lff -lgmp -ljsoncpp -lcrypto
 /**
  * Full Public Compact Proof of Retrievability protocol
  * Except verification step, every step generates files in order to store
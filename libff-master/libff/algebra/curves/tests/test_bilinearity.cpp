@@ -12,6 +12,8 @@
 #include <libff/algebra/curves/alt_bn128/alt_bn128_pp.hpp>
 #include <libff/algebra/curves/mnt/mnt4/mnt4_pp.hpp>
 #include <libff/algebra/curves/mnt/mnt6/mnt6_pp.hpp>
+#include <libff/algebra/curves/curve_utils.hpp>
+#include <sstream>
 
 using namespace libff;
 
@@ -74,6 +76,141 @@ void double_miller_loop_test()
     assert(ans_1 * ans_2 == ans_12);
 }
 
+template<typename ppT>
+void multi_miller_loop_test()
+{
+    std::vector<G1_precomp<ppT> > prec_P;
+    std::vector<G2_precomp<ppT> > prec_Q;
+    Fqk<ppT> expected = Fqk<ppT>::one();
+
+    assert(ppT::multi_miller_loop(prec_P, prec_Q) == expected);
+    for (size_t i = 0; i < 5; ++i)
+    {
+        const G1<ppT> P = (Fr<ppT>::random_element()) * G1<ppT>::one();
+        const G2<ppT> Q = (Fr<ppT>::random_element()) * G2<ppT>::one();
+        prec_P.emplace_back(ppT::precompute_G1(P));
+        prec_Q.emplace_back(ppT::precompute_G2(Q));
+
+        expected = expected * ppT::miller_loop(prec_P.back(), prec_Q.back());
+        assert(ppT::multi_miller_loop(prec_P, prec_Q) == expected);
+    }
+
+    assert(ppT::double_miller_loop(prec_P[0], prec_Q[0], prec_P[1], prec_Q[1]) ==
+           ppT::multi_miller_loop(std::vector<G1_precomp<ppT> >(prec_P.begin(), prec_P.begin() + 2),
+                                  std::vector<G2_precomp<ppT> >(prec_Q.begin(), prec_Q.begin() + 2)));
+}
+
+template<typename ppT>
+void multi_reduced_pairing_test()
+{
+    std::vector<G1<ppT> > P;
+    std::vector<G2<ppT> > Q;
+    GT<ppT> expected = GT<ppT>::one();
+    for (size_t i = 0; i < 7; ++i)
+    {
+        P.emplace_back((Fr<ppT>::random_element()) * G1<ppT>::one());
+        Q.emplace_back((Fr<ppT>::random_element()) * G2<ppT>::one());
+        expected = expected * ppT::reduced_pairing(P.back(), Q.back());
+    }
+
+    assert(ppT::multi_reduced_pairing(P, Q) == expected);
+}
+
+template<typename ppT>
+void pairing_product_is_one_test()
+{
+    const G1<ppT> P = (Fr<ppT>::random_element()) * G1<ppT>::one();
+    const G2<ppT> Q = (Fr<ppT>::random_element()) * G2<ppT>::one();
+    const Fr<ppT> s = Fr<ppT>::random_element();
+
+    assert(pairing_product_is_one<ppT>({}, {}));
+    assert(pairing_product_is_one<ppT>({s * P, -P}, {Q, s * Q}));
+    assert(!pairing_product_is_one<ppT>({s * P, -P}, {Q, (s + Fr<ppT>::one()) * Q}));
+    assert(!pairing_product_is_one<ppT>({P}, {Q}));
+}
+
+/*
+  A textbook optimal ate Miller loop for alt_bn128: Q is untwisted to E(Fq12),
+  and each line through T (and T or Q') is evaluated at P with affine slopes.
+  It must agree with alt_bn128_ate_miller_loop after the final exponentiation,
+  which removes the factors in proper subfields that set the two apart.
+*/
+void alt_bn128_miller_loop_reference_test()
+{
+    typedef std::pair<alt_bn128_Fq12, alt_bn128_Fq12> point;
+
+    const alt_bn128_G1 P = (alt_bn128_Fr::random_element()) * alt_bn128_G1::one();
+    const alt_bn128_G2 Q = (alt_bn128_Fr::random_element()) * alt_bn128_G2::one();
+    alt_bn128_G1 P_affine = P;
+    P_affine.to_affine_coordinates();
+    alt_bn128_G2 Q_affine = Q;
+    Q_affine.to_affine_coordinates();
+
+    const alt_bn128_Fq2 zero2 = alt_bn128_Fq2::zero();
+    const alt_bn128_Fq6 zero6 = alt_bn128_Fq6::zero();
+    const alt_bn128_Fq12 xP(alt_bn128_Fq6(alt_bn128_Fq2(P_affine.X, alt_bn128_Fq::zero()), zero2, zero2), zero6);
+    const alt_bn128_Fq12 yP(alt_bn128_Fq6(alt_bn128_Fq2(P_affine.Y, alt_bn128_Fq::zero()), zero2, zero2), zero6);
+    /* (x, y) -> (x w^2, y w^3), with w^2 = v */
+    const point Q12(alt_bn128_Fq12(alt_bn128_Fq6(zero2, Q_affine.X, zero2), zero6),
+                    alt_bn128_Fq12(zero6, alt_bn128_Fq6(zero2, Q_affine.Y, zero2)));
+
+    alt_bn128_Fq12 f = alt_bn128_Fq12::one();
+    point T = Q12;
+    /* f = f * (line through T and R, at P); T = T + R */
+    const auto add_line = [&](const point &R) {
+        const alt_bn128_Fq12 slope = (T == R ?
+                                      (T.first.squared() + T.first.squared() + T.first.squared()) * (T.second + T.second).inverse() :
+                                      (R.second - T.second) * (R.first - T.first).inverse());
+        f = f * (yP - T.second - slope * (xP - T.first));
+        const alt_bn128_Fq12 x = slope.squared() - T.first - R.first;
+        T = point(x, slope * (T.first - x) - T.second);
+    };
+
+    assert(!alt_bn128_ate_is_loop_count_neg);
+    const bigint<alt_bn128_q_limbs> &loop_count = alt_bn128_ate_loop_count;
+    for (long i = loop_count.num_bits() - 2; i >= 0; --i)
+    {
+        f = f.squared();
+        add_line(T);
+        if (loop_count.test_bit(i))
+        {
+            add_line(Q12);
+        }
+    }
+    const point Q1(Q12.first.Frobenius_map(1), Q12.second.Frobenius_map(1));
+    const point Q2(Q1.first.Frobenius_map(1), -Q1.second.Frobenius_map(1));
+    add_line(Q1);
+    add_line(Q2);
+
+    const alt_bn128_Fq12 naf = alt_bn128_ate_miller_loop(alt_bn128_ate_precompute_G1(P), alt_bn128_ate_precompute_G2(Q));
+    assert(alt_bn128_final_exponentiation(naf) == alt_bn128_final_exponentiation(f));
+}
+
+void alt_bn128_ate_G2_precomp_serialization_test()
+{
+    const alt_bn128_ate_G2_precomp prec_Q = alt_bn128_ate_precompute_G2((alt_bn128_Fr::random_element()) * alt_bn128_G2::one());
+
+    /* round trip */
+    std::stringstream ss;
+    ss << prec_Q;
+    alt_bn128_ate_G2_precomp prec_Q_copy;
+    ss >> prec_Q_copy;
+    assert(ss && prec_Q_copy == prec_Q);
+
+    /* precomputations for another loop are rejected: other version, or other number of coeffs */
+    std::stringstream ss_other_version;
+    ss_other_version << (alt_bn128_ate_G2_precomp::serialization_version + 1) << ss.str().substr(ss.str().find('\n'));
+    ss_other_version >> prec_Q_copy;
+    assert(!ss_other_version);
+
+    alt_bn128_ate_G2_precomp prec_Q_short = prec_Q;
+    prec_Q_short.coeffs.pop_back();
+    std::stringstream ss_short;
+    ss_short << prec_Q_short;
+    ss_short >> prec_Q_copy;
+    assert(!ss_short);
+}
+
 template<typename ppT>
 void affine_pairing_test()
 {
@@ -108,31 +245,142 @@ void affine_pairing_test()
     printf("\n\n");
 }
 
+template<typename ppT>
+void affine_ate_precomputation_test()
+{
+    const G1<ppT> P1 = (Fr<ppT>::random_element()) * G1<ppT>::one();
+    const G1<ppT> P2 = (Fr<ppT>::random_element()) * G1<ppT>::one();
+    const G2<ppT> Q1 = (Fr<ppT>::random_element()) * G2<ppT>::one();
+    const G2<ppT> Q2 = (Fr<ppT>::random_element()) * G2<ppT>::one();
+
+    const affine_ate_G1_precomp<ppT> prec_P1 = ppT::affine_ate_precompute_G1(P1);
+    const affine_ate_G1_precomp<ppT> prec_P2 = ppT::affine_ate_precompute_G1(P2);
+    const affine_ate_G2_precomp<ppT> prec_Q1 = ppT::affine_ate_precompute_G2(Q1);
+    const affine_ate_G2_precomp<ppT> prec_Q2 = ppT::affine_ate_precompute_G2(Q2);
+
+    const GT<ppT> ans_1 = ppT::reduced_pairing(P1, Q1);
+    const GT<ppT> ans_2 = ppT::reduced_pairing(P2, Q2);
+    assert(ppT::final_exponentiation(ppT::affine_ate_miller_loop(prec_P1, prec_Q1)) == ans_1);
+    assert(ppT::final_exponentiation(ppT::affine_ate_e_over_e_miller_loop(prec_P1, prec_Q1, prec_P2, prec_Q2)) ==
+           ans_1 * ans_2.unitary_inverse());
+
+    /* round trip, and rejection of other versions */
+    std::stringstream ss;
+    ss << prec_Q1;
+    affine_ate_G2_precomp<ppT> prec_Q1_copy;
+    ss >> prec_Q1_copy;
+    assert(ss && prec_Q1_copy == prec_Q1);
+
+    std::stringstream ss_other;
+    ss_other << (affine_ate_G2_precomp<ppT>::serialization_version + 1) << ss.str().substr(ss.str().find('\n'));
+    ss_other >> prec_Q1_copy;
+    assert(!ss_other);
+}
+
+void alt_bn128_GT_exp_test()
+{
+    const alt_bn128_GT x = alt_bn128_pp::reduced_pairing((alt_bn128_Fr::random_element()) * alt_bn128_G1::one(),
+                                                         (alt_bn128_Fr::random_element()) * alt_bn128_G2::one());
+
+    assert(alt_bn128_GT_exp(x, alt_bn128_Fr::zero()) == alt_bn128_GT::one());
+    assert(alt_bn128_GT_exp(x, alt_bn128_Fr::one()) == x);
+    assert(alt_bn128_GT_exp(x, -alt_bn128_Fr::one()) == x.unitary_inverse());
+    for (size_t i = 0; i < 10; ++i)
+    {
+        const alt_bn128_Fr k = alt_bn128_Fr::random_element();
+        assert(alt_bn128_GT_exp(x, k) == (x^k.as_bigint()));
+        assert(x.cyclotomic_exp(k.as_bigint()) == (x^k.as_bigint()));
+    }
+
+    std::vector<alt_bn128_GT> elts;
+    std::vector<alt_bn128_Fr> exponents;
+    alt_bn128_GT expected = alt_bn128_GT::one();
+    for (size_t i = 0; i < 5; ++i)
+    {
+        elts.emplace_back(alt_bn128_GT_exp(x, alt_bn128_Fr::random_element()));
+        exponents.emplace_back(alt_bn128_Fr::random_element());
+        expected = expected * (elts.back()^exponents.back().as_bigint());
+    }
+    assert(alt_bn128_GT_multi_exp(elts, exponents) == expected);
+    assert(alt_bn128_GT_multi_exp({}, {}) == alt_bn128_GT::one());
+}
+
+/*
+  the final exponentiation against the naive one; it raises to the multiple
+  2z(6z^2 + 3z + 1) of alt_bn128_final_exponent (see the last chunk). With
+  ALT_BN128_ATE_PAIRING this checks the ate-pairing backend.
+*/
+void alt_bn128_final_exponentiation_test()
+{
+    const bigint<alt_bn128_q_limbs> multiple("1469306990098747947464455738335385361638823152381947992820");
+    for (size_t i = 0; i < 3; ++i)
+    {
+        const alt_bn128_Fq12 f = alt_bn128_Fq12::random_element();
+        assert(alt_bn128_final_exponentiation(f) == ((f^alt_bn128_final_exponent)^multiple));
+    }
+}
+
+void alt_bn128_GT_subgroup_test()
+{
+    const alt_bn128_GT x = alt_bn128_pp::reduced_pairing((alt_bn128_Fr::random_element()) * alt_bn128_G1::one(),
+                                                         (alt_bn128_Fr::random_element()) * alt_bn128_G2::one());
+    assert(alt_bn128_GT_is_in_subgroup(x));
+    assert(alt_bn128_GT_is_in_subgroup(alt_bn128_GT::one()));
+    assert(!alt_bn128_GT_is_in_subgroup(alt_bn128_GT::zero()));
+
+    /* in the cyclotomic subgroup but not of order r */
+    const alt_bn128_Fq12 y = alt_bn128_Fq12::random_element();
+    assert(!alt_bn128_GT_is_in_subgroup(y));
+    alt_bn128_Fq12 c = y.Frobenius_map(6) * y.inverse();
+    c = c.Frobenius_map(2) * c;
+    assert(c.Frobenius_map(4) * c == c.Frobenius_map(2));
+    assert(!alt_bn128_GT_is_in_subgroup(c));
+    assert(!alt_bn128_GT_is_in_subgroup(x * c));
+}
+
 int main(void)
 {
     start_profiling();
     edwards_pp::init_public_params();
     pairing_test<edwards_pp>();
     double_miller_loop_test<edwards_pp>();
+    multi_miller_loop_test<edwards_pp>();
+    pairing_product_is_one_test<edwards_pp>();
 
     mnt6_pp::init_public_params();
     pairing_test<mnt6_pp>();
     double_miller_loop_test<mnt6_pp>();
+    multi_miller_loop_test<mnt6_pp>();
+    pairing_product_is_one_test<mnt6_pp>();
     affine_pairing_test<mnt6_pp>();
 
     mnt4_pp::init_public_params();
     pairing_test<mnt4_pp>();
     double_miller_loop_test<mnt4_pp>();
+    multi_miller_loop_test<mnt4_pp>();
+    pairing_product_is_one_test<mnt4_pp>();
     affine_pairing_test<mnt4_pp>();
 
     alt_bn128_pp::init_public_params();
     pairing_test<alt_bn128_pp>();
     double_miller_loop_test<alt_bn128_pp>();
+    multi_miller_loop_test<alt_bn128_pp>();
+    pairing_product_is_one_test<alt_bn128_pp>();
+    multi_reduced_pairing_test<alt_bn128_pp>();
+    affine_pairing_test<alt_bn128_pp>();
+    affine_ate_precomputation_test<alt_bn128_pp>();
+    alt_bn128_GT_exp_test();
+    alt_bn128_GT_subgroup_test();
+    alt_bn128_final_exponentiation_test();
+    alt_bn128_ate_G2_precomp_serialization_test();
+    alt_bn128_miller_loop_reference_test();
 
 #ifdef CURVE_BN128       // BN128 has fancy dependencies so it may be disabled
     bn128_pp::init_public_params();
     pairing_test<bn128_pp>();
     double_miller_loop_test<bn128_pp>();
+    multi_miller_loop_test<bn128_pp>();
+    pairing_product_is_one_test<bn128_pp>();
 #endif
 }
 
@@ -11,9 +11,12 @@
 #ifdef CURVE_BN128
 #include <libff/algebra/curves/bn128/bn128_pp.hpp>
 #endif
+#include <algorithm>
+#include <iterator>
 #include <sstream>
 
 #include <libff/algebra/curves/alt_bn128/alt_bn128_pp.hpp>
+#include <libff/algebra/scalar_multiplication/multiexp.hpp>
 
 using namespace libff;
 
@@ -120,6 +123,351 @@ void test_mul_by_q()
     assert((GroupT::base_field_char()*a) == a.mul_by_q());
 }
 
+template<typename GroupT, typename FieldT>
+void test_multi_exp_pippenger_signed()
+{
+    for (size_t length : { 0, 1, 7, 300 })
+    {
+        std::vector<GroupT> bases;
+        std::vector<FieldT> scalars;
+        for (size_t i = 0; i < length; ++i)
+        {
+            bases.emplace_back(GroupT::random_element());
+            bases.back().to_special();
+            scalars.emplace_back(FieldT::random_element());
+        }
+        if (length > 1)
+        {
+            /* all-ones digits carry through every window */
+            scalars[0] = -FieldT::one();
+            scalars[1] = FieldT::zero();
+        }
+
+        const GroupT expected = multi_exp<GroupT, FieldT, multi_exp_method_naive_plain>(
+            bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), 1);
+        assert((multi_exp<GroupT, FieldT, multi_exp_method_pippenger_signed>(
+            bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), 1)) == expected);
+        assert((multi_exp<GroupT, FieldT, multi_exp_method_pippenger_signed>(
+            bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), 3)) == expected);
+    }
+}
+
+template<typename GroupT, typename FieldT>
+void test_multi_exp_unbalanced()
+{
+    /* mostly zero and small scalars, with the large ones bunched at the end */
+    std::vector<GroupT> bases;
+    std::vector<FieldT> scalars;
+    for (size_t i = 0; i < 200; ++i)
+    {
+        bases.emplace_back(GroupT::random_element());
+        bases.back().to_special();
+        if (i >= 180)
+        {
+            scalars.emplace_back(FieldT::random_element());
+        }
+        else
+        {
+            scalars.emplace_back(i % 3 == 0 ? FieldT(i) : (i % 3 == 1 ? FieldT::one() : FieldT::zero()));
+        }
+    }
+
+    const GroupT expected = multi_exp<GroupT, FieldT, multi_exp_method_naive_plain>(
+        bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), 1);
+    for (size_t chunks : { 2, 4, 16 })
+    {
+        assert((multi_exp<GroupT, FieldT, multi_exp_method_bos_coster>(
+            bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), chunks)) == expected);
+        assert((multi_exp<GroupT, FieldT, multi_exp_method_BDLO12>(
+            bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), chunks)) == expected);
+        assert((multi_exp<GroupT, FieldT, multi_exp_method_pippenger_signed>(
+            bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), chunks)) == expected);
+        assert((multi_exp_with_mixed_addition<GroupT, FieldT, multi_exp_method_pippenger_signed>(
+            bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), chunks)) == expected);
+    }
+}
+
+template<typename GroupT, typename FieldT>
+void test_multi_exp_bos_coster_repeated()
+{
+    /* equal scalars make the heap compare the same exponents again */
+    const std::vector<std::vector<long> > cases = { { 3, 3, 6 }, { 5, 5, 5, 5 }, { 1, 2, 3, 3, 2, 1 } };
+    for (const std::vector<long> &values : cases)
+    {
+        std::vector<GroupT> bases;
+        std::vector<FieldT> scalars;
+        for (const long v : values)
+        {
+            bases.emplace_back(GroupT::random_element());
+            scalars.emplace_back(FieldT(v));
+        }
+
+        const GroupT expected = multi_exp<GroupT, FieldT, multi_exp_method_naive_plain>(
+            bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), 1);
+        assert((multi_exp<GroupT, FieldT, multi_exp_method_bos_coster>(
+            bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), 1)) == expected);
+    }
+}
+
+template<typename GroupT, typename FieldT>
+void test_multi_exp_small_scalars()
+{
+    for (size_t length : { 10, 200 })
+    {
+        for (size_t bits : { 1, 16, 40 })
+        {
+            std::vector<GroupT> bases;
+            std::vector<FieldT> scalars;
+            for (size_t i = 0; i < length; ++i)
+            {
+                bases.emplace_back(GroupT::random_element());
+                bases.back().to_special();
+                bigint<FieldT::num_limbs> scalar;
+                scalar.randomize();
+                for (size_t j = bits; j < scalar.max_bits(); ++j)
+                {
+                    scalar.data[j / GMP_NUMB_BITS] &= ~(1ul << (j % GMP_NUMB_BITS));
+                }
+                scalars.emplace_back(FieldT(scalar));
+            }
+
+            const GroupT expected = multi_exp<GroupT, FieldT, multi_exp_method_naive_plain>(
+                bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), 1);
+            assert((multi_exp<GroupT, FieldT, multi_exp_method_auto>(
+                bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), 1)) == expected);
+            assert((multi_exp<GroupT, FieldT, multi_exp_method_pippenger_signed>(
+                bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), 1)) == expected);
+            assert((multi_exp_with_mixed_addition<GroupT, FieldT, multi_exp_method_auto>(
+                bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), 2)) == expected);
+        }
+    }
+}
+
+template<typename GroupT, typename FieldT>
+void test_multi_exp_recoded()
+{
+    for (size_t length : { 0, 1, 10, 300 })
+    {
+        std::vector<FieldT> scalars;
+        for (size_t i = 0; i < length; ++i)
+        {
+            scalars.emplace_back(i % 3 == 0 ? FieldT(i) : FieldT::random_element());
+        }
+        const recoded_scalars<FieldT> recoded(scalars);
+        assert(recoded.size() == length);
+
+        // the same recoding against several sets of bases
+        for (size_t set = 0; set < 2; ++set)
+        {
+            std::vector<GroupT> bases;
+            for (size_t i = 0; i < length; ++i)
+            {
+                bases.emplace_back(GroupT::random_element());
+                bases.back().to_special();
+            }
+
+            const GroupT expected = multi_exp<GroupT, FieldT, multi_exp_method_naive_plain>(
+                bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), 1);
+            assert((multi_exp<GroupT, FieldT>(bases.cbegin(), bases.cend(), recoded)) == expected);
+            assert((multi_exp<GroupT, FieldT>(bases.data(), sizeof(GroupT), recoded)) == expected);
+        }
+    }
+
+    const recoded_scalars<FieldT> zeros(std::vector<FieldT>(5, FieldT::zero()));
+    const std::vector<GroupT> bases(5, GroupT::one());
+    assert((multi_exp<GroupT, FieldT>(bases.cbegin(), bases.cend(), zeros)).is_zero());
+}
+
+template<typename GroupT, typename FieldT>
+void test_multi_exp_workspace()
+{
+    multi_exp_workspace<GroupT, FieldT> workspace(300);
+    const GroupT *bases_data = workspace.bases.data();
+    const GroupT *g_data = workspace.g.data();
+    const GroupT *buckets_data = workspace.buckets.data();
+    const bigint<FieldT::num_limbs> *exponents_data = workspace.exponents.data();
+
+    for (size_t length : { 300, 0, 1, 2, 7, 100 })
+    {
+        std::vector<GroupT> bases;
+        std::vector<FieldT> scalars;
+        for (size_t i = 0; i < length; ++i)
+        {
+            bases.emplace_back(GroupT::random_element());
+            bases.back().to_special();
+            scalars.emplace_back(i % 4 == 0 ? FieldT::zero() : (i % 4 == 1 ? FieldT::one() : FieldT::random_element()));
+        }
+
+        const GroupT expected = multi_exp<GroupT, FieldT, multi_exp_method_naive_plain>(
+            bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), 1);
+        assert((multi_exp<GroupT, FieldT, multi_exp_method_bos_coster>(
+            bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), workspace)) == expected);
+        assert((multi_exp<GroupT, FieldT, multi_exp_method_pippenger_signed>(
+            bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), workspace)) == expected);
+        assert((multi_exp_with_mixed_addition<GroupT, FieldT, multi_exp_method_bos_coster>(
+            bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), workspace)) == expected);
+        assert((multi_exp_with_mixed_addition<GroupT, FieldT, multi_exp_method_pippenger_signed>(
+            bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), workspace)) == expected);
+        assert((multi_exp_with_mixed_addition<GroupT, FieldT, multi_exp_method_auto>(
+            bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), workspace)) == expected);
+    }
+
+    /* nothing was reallocated */
+    assert(workspace.bases.data() == bases_data);
+    assert(workspace.g.data() == g_data);
+    assert(workspace.buckets.data() == buckets_data);
+    assert(workspace.exponents.data() == exponents_data);
+
+    /* a workspace used on few elements grows for more, keeping the optimal window */
+    std::vector<GroupT> bases;
+    std::vector<FieldT> scalars;
+    size_t num_bits = 0;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        bases.emplace_back(i < 10 ? GroupT::random_element() : bases[i % 10]);
+        scalars.emplace_back(FieldT::random_element());
+        num_bits = std::max(num_bits, scalars.back().as_bigint().num_bits());
+    }
+    multi_exp_workspace<GroupT, FieldT> small_workspace(2);
+    assert((multi_exp<GroupT, FieldT, multi_exp_method_pippenger_signed>(
+        bases.cbegin(), bases.cbegin() + 2, scalars.cbegin(), scalars.cbegin() + 2, small_workspace)) ==
+           (multi_exp<GroupT, FieldT, multi_exp_method_naive_plain>(
+        bases.cbegin(), bases.cbegin() + 2, scalars.cbegin(), scalars.cbegin() + 2, 1)));
+    assert((multi_exp<GroupT, FieldT, multi_exp_method_pippenger_signed>(
+        bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), small_workspace)) ==
+           (multi_exp<GroupT, FieldT, multi_exp_method_BDLO12>(
+        bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), 1)));
+    assert(small_workspace.buckets.size() == 1ul << (pippenger_signed_window_size(bases.size(), num_bits) - 1));
+}
+
+template<typename GroupT, typename FieldT, typename CoordT>
+void test_multi_exp_strided()
+{
+    /* interleaved records, and affine coordinates with padding between points */
+    struct record {
+        FieldT scalar;
+        GroupT base;
+    };
+    const size_t length = 50;
+    std::vector<record> records(length);
+    std::vector<CoordT> coordinates(3 * length);
+    std::vector<GroupT> bases;
+    std::vector<FieldT> scalars;
+    for (size_t i = 0; i < length; ++i)
+    {
+        records[i].scalar = (i % 5 == 0 ? FieldT(i) : FieldT::random_element());
+        records[i].base = GroupT::random_element();
+        records[i].base.to_special();
+        coordinates[3 * i] = records[i].base.X;
+        coordinates[3 * i + 1] = records[i].base.Y;
+        bases.emplace_back(records[i].base);
+        scalars.emplace_back(records[i].scalar);
+    }
+
+    /* the iterators work with standard algorithms */
+    const strided_iterator<FieldT> first(&records[0].scalar, sizeof(record)), last = first + length;
+    assert(std::distance(first, last) == (long)length);
+    assert(std::equal(first, last, scalars.cbegin()));
+    assert(std::equal(std::reverse_iterator<strided_iterator<FieldT> >(last),
+                      std::reverse_iterator<strided_iterator<FieldT> >(first), scalars.crbegin()));
+    assert(first < last && 2 + first == std::next(first, 2) && (last - 1)[0] == scalars.back());
+    const affine_point_iterator<GroupT, CoordT> points(coordinates.data(), 3 * sizeof(CoordT));
+    assert(*std::prev(points + length) == bases.back());
+
+    const GroupT expected = multi_exp<GroupT, FieldT, multi_exp_method_naive_plain>(
+        bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), 1);
+    for (size_t chunks : { 1, 3 })
+    {
+        assert((multi_exp<GroupT, FieldT, multi_exp_method_bos_coster>(
+            &records[0].base, sizeof(record), &records[0].scalar, sizeof(record), length, chunks)) == expected);
+        assert((multi_exp<GroupT, FieldT, multi_exp_method_BDLO12>(
+            &records[0].base, sizeof(record), &records[0].scalar, sizeof(record), length, chunks)) == expected);
+        assert((multi_exp_affine<GroupT, FieldT, multi_exp_method_pippenger_signed>(
+            coordinates.data(), 3 * sizeof(CoordT), scalars.data(), sizeof(FieldT), length, chunks)) == expected);
+    }
+    assert((multi_exp_affine<GroupT, FieldT, multi_exp_method_naive>(
+        coordinates.data(), 3 * sizeof(CoordT), scalars.data(), sizeof(FieldT), length, 1)) == expected);
+    assert((multi_exp<GroupT, FieldT, multi_exp_method_pippenger_signed>(
+        bases.data(), sizeof(GroupT), scalars.data(), sizeof(FieldT), 0, 1)) == GroupT::zero());
+}
+
+template<typename GroupT, typename FieldT>
+void test_batch_exp_to_special()
+{
+    const GroupT g = GroupT::random_element();
+    for (size_t length : { 0, 1, 100 })
+    {
+        std::vector<FieldT> scalars;
+        for (size_t i = 0; i < length; ++i)
+        {
+            scalars.emplace_back(i % 10 == 0 ? FieldT(i / 10) : FieldT::random_element());
+        }
+        if (length > 1)
+        {
+            scalars[1] = -FieldT::one();
+        }
+
+        const std::vector<GroupT> powers = batch_exp_to_special(FieldT::size_in_bits(), g, scalars);
+        assert(powers.size() == length);
+        for (size_t i = 0; i < length; ++i)
+        {
+            assert(powers[i].is_special());
+            assert(powers[i] == scalars[i] * g);
+        }
+    }
+}
+
+template<typename GroupT, typename FieldT>
+void test_fixed_base_multi_exp()
+{
+    std::vector<GroupT> bases;
+    for (size_t i = 0; i < 30; ++i)
+    {
+        bases.emplace_back(GroupT::random_element());
+    }
+    bases[1] = GroupT::zero();
+
+    const size_t scalar_size = FieldT::size_in_bits();
+    for (size_t window : { (size_t)1, (size_t)5, get_fixed_base_multi_exp_window_size(bases.size(), scalar_size) })
+    {
+        const fixed_base_multi_exp_table<GroupT> table = get_fixed_base_multi_exp_table(scalar_size, window, bases);
+        assert(table.num_bases() == bases.size());
+
+        std::stringstream ss;
+        ss << table;
+        fixed_base_multi_exp_table<GroupT> table_copy;
+        ss >> table_copy;
+        assert(ss);
+
+        /* out-of-range windows are rejected */
+        for (size_t bad_window : { (size_t)0, fixed_base_multi_exp_max_window + 1, (size_t)64 })
+        {
+            std::stringstream bad;
+            fixed_base_multi_exp_table<GroupT> bad_table = table;
+            bad_table.window = bad_window;
+            bad << bad_table;
+            bad >> bad_table;
+            assert(bad.fail());
+        }
+
+        for (size_t j = 0; j < 2; ++j)
+        {
+            std::vector<FieldT> scalars;
+            for (size_t i = 0; i < bases.size(); ++i)
+            {
+                scalars.emplace_back(FieldT::random_element());
+            }
+            scalars[0] = -FieldT::one();
+            scalars[2] = FieldT::zero();
+
+            const GroupT expected = multi_exp<GroupT, FieldT, multi_exp_method_naive_plain>(
+                bases.cbegin(), bases.cend(), scalars.cbegin(), scalars.cend(), 1);
+            assert(fixed_base_multi_exp(table, scalars) == expected);
+            assert(fixed_base_multi_exp(table_copy, scalars) == expected);
+        }
+    }
+}
+
 template<typename GroupT>
 void test_output()
 {
@@ -137,6 +485,79 @@ void test_output()
     }
 }
 
+void test_alt_bn128_subgroup()
+{
+    assert(alt_bn128_G1::random_element().is_in_subgroup());
+    assert(alt_bn128_G2::zero().is_in_subgroup());
+    for (size_t i = 0; i < 10; ++i)
+    {
+        assert(alt_bn128_G2::random_element().is_in_subgroup());
+    }
+
+    /* a point of the twist outside G2 */
+    alt_bn128_Fq2 x, rhs;
+    do
+    {
+        x = alt_bn128_Fq2::random_element();
+        rhs = x.squared() * x + alt_bn128_twist_coeff_b;
+    } while ((rhs^alt_bn128_Fq2::euler) != alt_bn128_Fq2::one());
+    const alt_bn128_G2 Q(x, rhs.sqrt(), alt_bn128_Fq2::one());
+    assert(Q.is_well_formed() && !Q.is_in_subgroup());
+    assert(!(alt_bn128_G2::order() * Q).is_in_subgroup());
+
+    /* of order 10069, the smallest prime factor of the twist cofactor */
+    const bigint<8> order_over_10069("47581207271489010074683488451353534690560365133687637544587129035065060451520145913692443394996527310200940637954806362563397135354136976255533127257");
+    const alt_bn128_G2 T = order_over_10069 * Q;
+    assert(!T.is_zero() && (bigint<1>(10069) * T).is_zero());
+    assert(!T.is_in_subgroup());
+
+    /* not on the curve */
+    const alt_bn128_G2 g = alt_bn128_G2::random_element();
+    assert(!alt_bn128_G2(g.X, g.Y + alt_bn128_Fq2::one(), g.Z).is_in_subgroup());
+}
+
+void test_alt_bn128_map_to_curve()
+{
+    /* (u, x, y), from a direct transcription of RFC 9380, section 6.6.1 */
+    const char* expected[][3] = {
+        { "0",
+          "10944121435919637611123202872628637544348155578648911831344518947322613104291",
+          "4718603453640367770405249522358112449463417117041194427604452040985121683380" },
+        { "1",
+          "19699418584655347698258596782613050042691797047307431679640710698076539066151",
+          "10343751156573783632778856105235937123682780444565366714146603135794096447717" },
+        { "5",
+          "20262878302148239933902159870143739200212645228355066860207035924029037262790",
+          "9758744144075580486226292637147400604374287218633575049759831181260788318551" },
+        { "10944121435919637611123202872628637544348155578648911831344518947322613104292",
+          "10944121435919637611123202872628637544348155578648911831344518947322613104291",
+          "4718603453640367770405249522358112449463417117041194427604452040985121683380" },
+        { "21888242871839275222246405745257275088696311157297823662689037894645226208582",
+          "2188824287183927523987808962644225046004514109990391983048327196568687142431",
+          "7399068843397001083097024496093135224919265266911805500347547396964789457160" }
+    };
+
+    std::vector<alt_bn128_Fq> u;
+    for (auto &e : expected)
+    {
+        u.emplace_back(alt_bn128_Fq(e[0]));
+        alt_bn128_G1 P = alt_bn128_G1::map_to_curve(u.back());
+        P.to_affine_coordinates();
+        assert(P.X == alt_bn128_Fq(e[1]) && P.Y == alt_bn128_Fq(e[2]));
+    }
+    for (size_t i = 0; i < 20; ++i)
+    {
+        u.emplace_back(alt_bn128_Fq::random_element());
+    }
+
+    const std::vector<alt_bn128_G1> batch = alt_bn128_G1::batch_map_to_curve(u);
+    assert(batch.size() == u.size());
+    for (size_t i = 0; i < u.size(); ++i)
+    {
+        assert(batch[i].is_well_formed() && batch[i] == alt_bn128_G1::map_to_curve(u[i]));
+    }
+}
+
 int main(void)
 {
     edwards_pp::init_public_params();
@@ -145,6 +566,8 @@ int main(void)
     test_group<G2<edwards_pp> >();
     test_output<G2<edwards_pp> >();
     test_mul_by_q<G2<edwards_pp> >();
+    test_multi_exp_pippenger_signed<G1<edwards_pp>, Fr<edwards_pp> >();
+    test_multi_exp_bos_coster_repeated<G1<edwards_pp>, Fr<edwards_pp> >();
 
     mnt4_pp::init_public_params();
     test_group<G1<mnt4_pp> >();
@@ -152,6 +575,7 @@ int main(void)
     test_group<G2<mnt4_pp> >();
     test_output<G2<mnt4_pp> >();
     test_mul_by_q<G2<mnt4_pp> >();
+    test_multi_exp_bos_coster_repeated<G1<mnt4_pp>, Fr<mnt4_pp> >();
 
     mnt6_pp::init_public_params();
     test_group<G1<mnt6_pp> >();
@@ -166,6 +590,23 @@ int main(void)
     test_group<G2<alt_bn128_pp> >();
     test_output<G2<alt_bn128_pp> >();
     test_mul_by_q<G2<alt_bn128_pp> >();
+    test_alt_bn128_subgroup();
+    test_alt_bn128_map_to_curve();
+    test_multi_exp_pippenger_signed<G1<alt_bn128_pp>, Fr<alt_bn128_pp> >();
+    test_multi_exp_pippenger_signed<G2<alt_bn128_pp>, Fr<alt_bn128_pp> >();
+    test_multi_exp_unbalanced<G1<alt_bn128_pp>, Fr<alt_bn128_pp> >();
+    test_multi_exp_bos_coster_repeated<G1<alt_bn128_pp>, Fr<alt_bn128_pp> >();
+    test_multi_exp_small_scalars<G1<alt_bn128_pp>, Fr<alt_bn128_pp> >();
+    test_multi_exp_recoded<G1<alt_bn128_pp>, Fr<alt_bn128_pp> >();
+    test_multi_exp_recoded<G2<alt_bn128_pp>, Fr<alt_bn128_pp> >();
+    test_multi_exp_workspace<G1<alt_bn128_pp>, Fr<alt_bn128_pp> >();
+    test_multi_exp_workspace<G2<alt_bn128_pp>, Fr<alt_bn128_pp> >();
+    test_multi_exp_strided<G1<alt_bn128_pp>, Fr<alt_bn128_pp>, alt_bn128_Fq>();
+    test_multi_exp_strided<G2<alt_bn128_pp>, Fr<alt_bn128_pp>, alt_bn128_Fq2>();
+    test_batch_exp_to_special<G1<alt_bn128_pp>, Fr<alt_bn128_pp> >();
+    test_batch_exp_to_special<G2<alt_bn128_pp>, Fr<alt_bn128_pp> >();
+    test_fixed_base_multi_exp<G1<alt_bn128_pp>, Fr<alt_bn128_pp> >();
+    test_fixed_base_multi_exp<G2<alt_bn128_pp>, Fr<alt_bn128_pp> >();
 
 #ifdef CURVE_BN128       // BN128 has fancy dependencies so it may be disabled
     bn128_pp::init_public_params();
@@ -38,6 +38,9 @@ public:
     bigint(const unsigned long x); /// Initalize from a small integer
     bigint(const char* s); /// Initialize from a string containing an integer in decimal notation
     bigint(const mpz_t r); /// Initialize from MPZ element
+    /// Initialize from two or more limbs, least significant first; usable in constant expressions
+    template<typename... Limbs>
+    constexpr bigint(const mp_limb_t l0, const mp_limb_t l1, const Limbs... rest) : data{l0, l1, static_cast<mp_limb_t>(rest)...} {}
 
     void print() const;
     void print_hex() const;
@@ -51,6 +51,13 @@ FieldT convert_bit_vector_to_field_element(const bit_vector &v);
 template<typename FieldT>
 void batch_invert(std::vector<FieldT> &vec);
 
+/**
+ * Same as above, for vec[0..len-1], with one field inversion in total.
+ * Allocation-free: prod must have room for len elements.
+ */
+template<typename FieldT>
+void batch_invert(FieldT *vec, const size_t len, FieldT *prod);
+
 } // libff
 #include <libff/algebra/fields/field_utils.tcc>
 
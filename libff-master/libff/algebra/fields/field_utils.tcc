@@ -171,21 +171,25 @@ FieldT convert_bit_vector_to_field_element(const bit_vector &v)
 template<typename FieldT>
 void batch_invert(std::vector<FieldT> &vec)
 {
-    std::vector<FieldT> prod;
-    prod.reserve(vec.size());
+    std::vector<FieldT> prod(vec.size());
+    batch_invert(vec.data(), vec.size(), prod.data());
+}
 
+template<typename FieldT>
+void batch_invert(FieldT *vec, const size_t len, FieldT *prod)
+{
     FieldT acc = FieldT::one();
 
-    for (auto el : vec)
+    for (size_t i = 0; i < len; ++i)
     {
-        assert(!el.is_zero());
-        prod.emplace_back(acc);
-        acc = acc * el;
+        assert(!vec[i].is_zero());
+        prod[i] = acc;
+        acc = acc * vec[i];
     }
 
     FieldT acc_inverse = acc.inverse();
 
-    for (long i = static_cast<long>(vec.size()-1); i >= 0; --i)
+    for (long i = static_cast<long>(len)-1; i >= 0; --i)
     {
         const FieldT old_el = vec[i];
         vec[i] = acc_inverse * prod[i];
@@ -0,0 +1,100 @@
+/** @file
+ *****************************************************************************
+ Profiling of Fp_model squaring and inversion, for 3-, 4- and 5-limb fields.
+ *****************************************************************************
+ * @author     This file is part of libff, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <libff/algebra/curves/alt_bn128/alt_bn128_pp.hpp>
+#include <libff/algebra/curves/edwards/edwards_pp.hpp>
+#include <libff/algebra/curves/mnt/mnt4/mnt4_pp.hpp>
+#include <libff/common/profiling.hpp>
+
+using namespace libff;
+
+template<typename FieldT>
+void profile_squaring(const std::string &annotation)
+{
+    const size_t iterations = 1000000;
+    FieldT a = FieldT::random_element();
+    FieldT b = a;
+
+    long long start = get_nsec_time();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        a = a * a;
+    }
+    const long long mul_time = get_nsec_time() - start;
+
+    start = get_nsec_time();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        b = b.squared();
+    }
+    const long long sqr_time = get_nsec_time() - start;
+
+    if (a != b)
+    {
+        fprintf(stderr, "Answers NOT MATCHING (squared() != operator*)\n");
+    }
+    printf("%s: %zu squarings: %.2f ns each with squared(), %.2f ns each with operator*\n",
+           annotation.c_str(), iterations, double(sqr_time) / iterations, double(mul_time) / iterations);
+}
+
+template<typename FieldT>
+void profile_inversion(const std::string &annotation)
+{
+    const size_t iterations = 100000;
+    std::vector<FieldT> v(iterations);
+    for (FieldT &x : v)
+    {
+        x = FieldT::random_element();
+    }
+    std::vector<FieldT> gcdext_results(iterations), ct_results(iterations);
+
+    long long start = get_nsec_time();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        gcdext_results[i] = v[i].inverse();
+    }
+    const long long gcdext_time = get_nsec_time() - start;
+
+    start = get_nsec_time();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        ct_results[i] = v[i].inverse_ct();
+    }
+    const long long ct_time = get_nsec_time() - start;
+
+    if (gcdext_results != ct_results)
+    {
+        fprintf(stderr, "Answers NOT MATCHING (inverse_ct() != inverse())\n");
+    }
+    printf("%s: %zu inversions: %.2f ns each with inverse_ct(), %.2f ns each with inverse()\n",
+           annotation.c_str(), iterations, double(ct_time) / iterations, double(gcdext_time) / iterations);
+}
+
+int main(void)
+{
+    print_compilation_info();
+
+    edwards_pp::init_public_params();
+    alt_bn128_pp::init_public_params();
+    mnt4_pp::init_public_params();
+
+    profile_squaring<Fq<edwards_pp> >("edwards Fq (3 limbs)");
+    profile_squaring<Fq<alt_bn128_pp> >("alt_bn128 Fq (4 limbs)");
+    profile_squaring<Fq<mnt4_pp> >("mnt4 Fq (5 limbs)");
+
+    profile_inversion<Fq<edwards_pp> >("edwards Fq (3 limbs)");
+    profile_inversion<Fq<alt_bn128_pp> >("alt_bn128 Fq (4 limbs)");
+    profile_inversion<Fq<mnt4_pp> >("mnt4 Fq (5 limbs)");
+
+    return 0;
+}
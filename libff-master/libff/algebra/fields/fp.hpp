@@ -12,6 +12,9 @@
 
 #include <libff/algebra/exponentiation/exponentiation.hpp>
 #include <libff/algebra/fields/bigint.hpp>
+#ifdef USE_JIT
+#include <libff/algebra/fields/fp_jit.hpp>
+#endif
 
 namespace libff {
 
@@ -24,6 +27,20 @@ std::ostream& operator<<(std::ostream &, const Fp_model<n, modulus>&);
 template<mp_size_t n, const bigint<n>& modulus>
 std::istream& operator>>(std::istream &, Fp_model<n, modulus> &);
 
+/**
+ * Montgomery parameters of a modulus known at compile time. A curve provides
+ * them by specializing this template with available = true and the constexpr
+ * members modulus, Rsquared, Rcubed (of type bigint<n>) and inv (of type
+ * mp_limb_t), as alt_bn128_init.hpp does. Fp_model then multiplies and
+ * squares with code specialized for these constants (see fp_constexpr.tcc)
+ * instead of GMP or the generic assembly, and adds and subtracts with it
+ * unless compiled with USE_ASM on x86-64.
+ */
+template<mp_size_t n, const bigint<n>& modulus>
+struct fp_constexpr_params {
+    static const bool available = false;
+};
+
 /**
  * Arithmetic in the finite field F[p], for prime p of fixed length.
  *
@@ -62,6 +79,13 @@ public:
     static mp_limb_t inv; // modulus^(-1) mod W, where W = 2^(word size)
     static bigint<n> Rsquared; // R^2, where R = W^k, where k = ??
     static bigint<n> Rcubed;   // R^3
+#ifdef USE_JIT
+    static fp_jit_routines jit; // runtime-generated routines, null until init_jit()
+#endif
+
+    /* Generate the JIT routines for this modulus (a no-op without USE_JIT);
+       to be called by init_*_params() once modulus and inv are set. */
+    static void init_jit();
 
     static bool modulus_is_valid() { return modulus.data[n-1] != 0; } // mpn inverse assumes that highest limb is non-zero
 
@@ -105,12 +129,31 @@ public:
     Fp_model squared() const;
     Fp_model& invert();
     Fp_model inverse() const;
+    /* as invert()/inverse(), but in time independent of the value; for secret-dependent inputs,
+       as it is slower than mpn_gcdext (see fields_profile) */
+    Fp_model& invert_ct();
+    Fp_model inverse_ct() const;
     Fp_model sqrt() const; // HAS TO BE A SQUARE (else does not terminate)
 
     Fp_model operator^(const unsigned long pow) const;
     template<mp_size_t m>
     Fp_model operator^(const bigint<m> &pow) const;
 
+    /*
+      Lazy reduction, used by the extension fields: Montgomery representations
+      are multiplied into double-width integers T < modulus * R, which can be
+      added and subtracted (modulo modulus * R) before a single
+      montgomery_reduce() per output coefficient. Products of two reduced
+      representations, and of two sum_unreduced() values, stay in range as
+      long as 4 * modulus < R.
+    */
+    static bigint<n> sum_unreduced(const Fp_model &a, const Fp_model &b); // a.mont_repr + b.mont_repr, without reduction
+    static void mul_unreduced(bigint<2*n> &res, const bigint<n> &a, const bigint<n> &b);
+    static void sqr_unreduced(bigint<2*n> &res, const bigint<n> &a);
+    static void add_unreduced(bigint<2*n> &res, const bigint<2*n> &a, const bigint<2*n> &b);
+    static void sub_unreduced(bigint<2*n> &res, const bigint<2*n> &a, const bigint<2*n> &b);
+    static Fp_model montgomery_reduce(bigint<2*n> &T); // T * R^(-1) mod modulus; overwrites T
+
     static size_t size_in_bits() { return num_bits; }
     static size_t capacity() { return num_bits - 1; }
     static bigint<n> field_char() { return modulus; }
@@ -125,6 +168,20 @@ public:
     friend std::istream& operator>> <n,modulus>(std::istream &in, Fp_model<n, modulus> &p);
 };
 
+/**
+ * Element-wise product out[i] = a[i] * b[i] for i = 0..len-1.
+ *
+ * For 4-limb moduli on x86-64 CPUs with AVX-512 IFMA (and USE_ASM defined),
+ * 8 products are computed at a time in vector registers; other cases, and the
+ * remaining len % 8 elements, use the scalar multiplication. The CPU check is
+ * done once at runtime. out may alias a or b.
+ */
+template<mp_size_t n, const bigint<n>& modulus>
+void batch_mul(const Fp_model<n, modulus> *a, const Fp_model<n, modulus> *b, Fp_model<n, modulus> *out, const size_t len);
+
+template<mp_size_t n, const bigint<n>& modulus>
+void batch_mul(const std::vector<Fp_model<n, modulus> > &a, const std::vector<Fp_model<n, modulus> > &b, std::vector<Fp_model<n, modulus> > &out);
+
 #ifdef PROFILE_OP_COUNTS
 template<mp_size_t n, const bigint<n>& modulus>
 long long Fp_model<n, modulus>::add_cnt = 0;
@@ -178,6 +235,11 @@ bigint<n> Fp_model<n, modulus>::Rsquared;
 template<mp_size_t n, const bigint<n>& modulus>
 bigint<n> Fp_model<n, modulus>::Rcubed;
 
+#ifdef USE_JIT
+template<mp_size_t n, const bigint<n>& modulus>
+fp_jit_routines Fp_model<n, modulus>::jit;
+#endif
+
 } // libff
 #include <libff/algebra/fields/fp.tcc>
 
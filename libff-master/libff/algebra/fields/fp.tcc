@@ -16,12 +16,38 @@
 
 #include <libff/algebra/fields/field_utils.hpp>
 #include <libff/algebra/fields/fp_aux.tcc>
+#include <libff/algebra/fields/fp_constexpr.tcc>
+#include <libff/algebra/fields/fp_ifma.tcc>
+#include <libff/algebra/fields/fp_safegcd.tcc>
 
 namespace libff {
 
+template<mp_size_t n, const bigint<n>& modulus>
+void Fp_model<n,modulus>::init_jit()
+{
+#ifdef USE_JIT
+    if (jit.mul == nullptr)
+    {
+        fp_jit_generate(jit, n, modulus.data, inv);
+    }
+#endif
+}
+
 template<mp_size_t n, const bigint<n>& modulus>
 void Fp_model<n,modulus>::mul_reduce(const bigint<n> &other)
 {
+#ifdef USE_JIT
+    if (jit.mul != nullptr)
+    {
+        jit.mul(this->mont_repr.data, this->mont_repr.data, other.data);
+        return;
+    }
+#endif
+    if (fp_constexpr_params<n, modulus>::available)
+    {
+        fp_constexpr_arith<n, fp_constexpr_params<n, modulus> >::mul(this->mont_repr.data, this->mont_repr.data, other.data);
+        return;
+    }
     /* stupid pre-processor tricks; beware */
 #if defined(__x86_64__) && defined(USE_ASM)
     if (n == 3)
@@ -320,6 +346,20 @@ Fp_model<n,modulus>& Fp_model<n,modulus>::operator+=(const Fp_model<n,modulus>&
 #ifdef PROFILE_OP_COUNTS
     this->add_cnt++;
 #endif
+#ifdef USE_JIT
+    if (jit.add != nullptr)
+    {
+        jit.add(this->mont_repr.data, this->mont_repr.data, other.mont_repr.data);
+        return *this;
+    }
+#endif
+#if !(defined(__x86_64__) && defined(USE_ASM)) // the assembly below is faster
+    if (fp_constexpr_params<n, modulus>::available)
+    {
+        fp_constexpr_arith<n, fp_constexpr_params<n, modulus> >::add(this->mont_repr.data, this->mont_repr.data, other.mont_repr.data);
+        return *this;
+    }
+#endif
 #if defined(__x86_64__) && defined(USE_ASM)
     if (n == 3)
     {
@@ -437,6 +477,20 @@ Fp_model<n,modulus>& Fp_model<n,modulus>::operator-=(const Fp_model<n,modulus>&
 #ifdef PROFILE_OP_COUNTS
     this->sub_cnt++;
 #endif
+#ifdef USE_JIT
+    if (jit.sub != nullptr)
+    {
+        jit.sub(this->mont_repr.data, this->mont_repr.data, other.mont_repr.data);
+        return *this;
+    }
+#endif
+#if !(defined(__x86_64__) && defined(USE_ASM)) // the assembly below is faster
+    if (fp_constexpr_params<n, modulus>::available)
+    {
+        fp_constexpr_arith<n, fp_constexpr_params<n, modulus> >::sub(this->mont_repr.data, this->mont_repr.data, other.mont_repr.data);
+        return *this;
+    }
+#endif
 #if defined(__x86_64__) && defined(USE_ASM)
     if (n == 3)
     {
@@ -611,8 +665,21 @@ Fp_model<n,modulus> Fp_model<n,modulus>::squared() const
 {
 #ifdef PROFILE_OP_COUNTS
     this->sqr_cnt++;
-    this->mul_cnt--; // zero out the upcoming mul
 #endif
+#ifdef USE_JIT
+    if (jit.sqr != nullptr)
+    {
+        Fp_model<n, modulus> r;
+        jit.sqr(r.mont_repr.data, this->mont_repr.data, this->mont_repr.data);
+        return r;
+    }
+#endif
+    if (fp_constexpr_params<n, modulus>::available)
+    {
+        Fp_model<n, modulus> r;
+        fp_constexpr_arith<n, fp_constexpr_params<n, modulus> >::sqr(r.mont_repr.data, this->mont_repr.data);
+        return r;
+    }
     /* stupid pre-processor tricks; beware */
 #if defined(__x86_64__) && defined(USE_ASM)
     if (n == 3)
@@ -646,9 +713,46 @@ Fp_model<n,modulus> Fp_model<n,modulus>::squared() const
         mpn_copyi(r.mont_repr.data, res+n, n);
         return r;
     }
+    else if (n == 5)
+    { // use asm-optimized Comba squaring
+        mp_limb_t res[2*n];
+        mp_limb_t c0, c1, c2;
+        COMBA_5_BY_5_SQR(c0, c1, c2, res, this->mont_repr.data);
+
+        mp_limb_t k, c;
+        REDUCE_10_LIMB_PRODUCT(k, c, inv, res, modulus.data);
+
+        /* subtract t > mod */
+        __asm__ volatile
+            ("/* check for overflow */        \n\t"
+             MONT_CMP(32)
+             MONT_CMP(24)
+             MONT_CMP(16)
+             MONT_CMP(8)
+             MONT_CMP(0)
+
+             "/* subtract mod if overflow */  \n\t"
+             "subtract%=:                     \n\t"
+             MONT_FIRSTSUB
+             MONT_NEXTSUB(8)
+             MONT_NEXTSUB(16)
+             MONT_NEXTSUB(24)
+             MONT_NEXTSUB(32)
+             "done%=:                         \n\t"
+             :
+             : [tmp] "r" (res+n), [M] "r" (modulus.data)
+             : "cc", "memory", "%rax");
+
+        Fp_model<n, modulus> r;
+        mpn_copyi(r.mont_repr.data, res+n, n);
+        return r;
+    }
     else
 #endif
     {
+#ifdef PROFILE_OP_COUNTS
+        this->mul_cnt--; // zero out the upcoming mul
+#endif
         Fp_model<n, modulus> r(*this);
         return (r *= r);
     }
@@ -715,6 +819,35 @@ Fp_model<n,modulus> Fp_model<n,modulus>::inverse() const
     return (r.invert());
 }
 
+template<mp_size_t n, const bigint<n>& modulus>
+Fp_model<n,modulus>& Fp_model<n,modulus>::invert_ct()
+{
+#ifdef PROFILE_OP_COUNTS
+    this->inv_cnt++;
+#endif
+
+    assert(!this->is_zero());
+
+#if defined(__SIZEOF_INT128__) && GMP_NUMB_BITS == 64
+    /* constant time and allocation-free; see fp_safegcd.tcc */
+    safegcd_invert<n>(this->mont_repr.data, this->mont_repr.data, modulus.data, inv, modulus.num_bits());
+    mul_reduce(Rcubed);
+#else
+    /* x^(p-2); the square-and-multiply chain only depends on the public modulus */
+    bigint<n> p_minus_2 = modulus;
+    mpn_sub_1(p_minus_2.data, p_minus_2.data, n, 2);
+    *this = (*this) ^ p_minus_2;
+#endif
+    return *this;
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+Fp_model<n,modulus> Fp_model<n,modulus>::inverse_ct() const
+{
+    Fp_model<n, modulus> r(*this);
+    return (r.invert_ct());
+}
+
 template<mp_size_t n, const bigint<n>& modulus>
 Fp_model<n, modulus> Fp_model<n,modulus>::random_element() /// returns random element of Fp_model
 {
@@ -825,5 +958,168 @@ std::istream& operator>>(std::istream &in, Fp_model<n, modulus> &p)
     return in;
 }
 
+template<mp_size_t n, const bigint<n>& modulus>
+bigint<n> Fp_model<n,modulus>::sum_unreduced(const Fp_model<n,modulus> &a, const Fp_model<n,modulus> &b)
+{
+    bigint<n> res;
+    const mp_limb_t carry = mpn_add_n(res.data, a.mont_repr.data, b.mont_repr.data, n);
+#ifndef NDEBUG
+    assert(carry == 0);
+#else
+    UNUSED(carry);
+#endif
+    return res;
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+void Fp_model<n,modulus>::mul_unreduced(bigint<2*n> &res, const bigint<n> &a, const bigint<n> &b)
+{
+#ifdef PROFILE_OP_COUNTS
+    mul_cnt++;
+#endif
+    /* stupid pre-processor tricks; beware */
+#if defined(__x86_64__) && defined(USE_ASM)
+    mp_limb_t c0, c1, c2;
+    if (n == 3)
+    {
+        COMBA_3_BY_3_MUL(c0, c1, c2, res.data, a.data, b.data);
+    }
+    else if (n == 4)
+    {
+        COMBA_4_BY_4_MUL(c0, c1, c2, res.data, a.data, b.data);
+    }
+    else if (n == 5)
+    {
+        COMBA_5_BY_5_MUL(c0, c1, c2, res.data, a.data, b.data);
+    }
+    else
+#endif
+    {
+        mpn_mul_n(res.data, a.data, b.data, n);
+    }
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+void Fp_model<n,modulus>::sqr_unreduced(bigint<2*n> &res, const bigint<n> &a)
+{
+#ifdef PROFILE_OP_COUNTS
+    sqr_cnt++;
+#endif
+    /* stupid pre-processor tricks; beware */
+#if defined(__x86_64__) && defined(USE_ASM)
+    mp_limb_t c0, c1, c2;
+    if (n == 3)
+    {
+        COMBA_3_BY_3_SQR(c0, c1, c2, res.data, a.data);
+    }
+    else if (n == 5)
+    {
+        COMBA_5_BY_5_SQR(c0, c1, c2, res.data, a.data);
+    }
+    else
+#endif
+    {
+        mpn_sqr(res.data, a.data, n);
+    }
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+void Fp_model<n,modulus>::add_unreduced(bigint<2*n> &res, const bigint<2*n> &a, const bigint<2*n> &b)
+{
+    mpn_add_n(res.data, a.data, b.data, 2*n);
+    /* res >= modulus * R iff its upper half is >= modulus */
+    if (mpn_cmp(res.data+n, modulus.data, n) >= 0)
+    {
+        mpn_sub_n(res.data+n, res.data+n, modulus.data, n);
+    }
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+void Fp_model<n,modulus>::sub_unreduced(bigint<2*n> &res, const bigint<2*n> &a, const bigint<2*n> &b)
+{
+    if (mpn_sub_n(res.data, a.data, b.data, 2*n))
+    {
+        /* add back modulus * R; the carry out cancels the borrow */
+        mpn_add_n(res.data+n, res.data+n, modulus.data, n);
+    }
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+Fp_model<n,modulus> Fp_model<n,modulus>::montgomery_reduce(bigint<2*n> &T)
+{
+    /* stupid pre-processor tricks; beware */
+#if defined(__x86_64__) && defined(USE_ASM)
+    mp_limb_t k, c;
+    if (n == 3)
+    {
+        mp_limb_t tmp1, tmp2, tmp3;
+        REDUCE_6_LIMB_PRODUCT(k, tmp1, tmp2, tmp3, inv, T.data, modulus.data);
+    }
+    else if (n == 4)
+    {
+        REDUCE_8_LIMB_PRODUCT(k, c, inv, T.data, modulus.data);
+    }
+    else if (n == 5)
+    {
+        REDUCE_10_LIMB_PRODUCT(k, c, inv, T.data, modulus.data);
+    }
+    else
+#endif
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            mp_limb_t k = inv * T.data[i];
+            /* calculate T = T + k * mod * b^i */
+            mp_limb_t carryout = mpn_addmul_1(T.data+i, modulus.data, n, k);
+            carryout = mpn_add_1(T.data+n+i, T.data+n+i, n-i, carryout);
+            assert(carryout == 0);
+        }
+    }
+
+    Fp_model<n,modulus> res;
+    if (mpn_cmp(T.data+n, modulus.data, n) >= 0)
+    {
+        mpn_sub_n(res.mont_repr.data, T.data+n, modulus.data, n);
+    }
+    else
+    {
+        mpn_copyi(res.mont_repr.data, T.data+n, n);
+    }
+    return res;
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+void batch_mul(const Fp_model<n, modulus> *a, const Fp_model<n, modulus> *b, Fp_model<n, modulus> *out, const size_t len)
+{
+    size_t i = 0;
+#if defined(__x86_64__) && defined(USE_ASM)
+    if (n == 4 && cpu_supports_avx512_ifma())
+    {
+        const size_t stride = sizeof(Fp_model<n, modulus>) / sizeof(mp_limb_t);
+        for (; i + 8 <= len; i += 8)
+        {
+            mont_mul_4_ifma_x8(out[i].mont_repr.data, a[i].mont_repr.data, b[i].mont_repr.data, stride,
+                               modulus.data, Fp_model<n, modulus>::inv);
+        }
+#ifdef PROFILE_OP_COUNTS
+        Fp_model<n, modulus>::mul_cnt += i;
+#endif
+    }
+#endif
+
+    for (; i < len; ++i)
+    {
+        out[i] = a[i] * b[i];
+    }
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+void batch_mul(const std::vector<Fp_model<n, modulus> > &a, const std::vector<Fp_model<n, modulus> > &b, std::vector<Fp_model<n, modulus> > &out)
+{
+    assert(a.size() == b.size());
+    out.resize(a.size());
+    batch_mul(a.data(), b.data(), out.data(), a.size());
+}
+
 } // libff
 #endif // FP_TCC_
@@ -70,13 +70,29 @@ public:
     Fp12_2over3over2_model Frobenius_map(unsigned long power) const;
     Fp12_2over3over2_model unitary_inverse() const;
     Fp12_2over3over2_model cyclotomic_squared() const;
+    /*
+      Karabina's compressed squaring in the cyclotomic subgroup: reads and
+      writes only c0.c1, c0.c2, c1.c0 and c1.c2. The other two coefficients
+      are recovered by decompress_cyclotomic.
+    */
+    Fp12_2over3over2_model cyclotomic_squared_compressed() const;
+    static void decompress_cyclotomic(std::vector<Fp12_2over3over2_model> &vec); // one inversion for all of vec
 
     Fp12_2over3over2_model mul_by_024(const my_Fp2 &ell_0, const my_Fp2 &ell_VW, const my_Fp2 &ell_VV) const;
+    /* product of two elements of the form mul_by_024 multiplies by; c1.c2 of the result is zero */
+    static Fp12_2over3over2_model mul_024_by_024(const my_Fp2 &ell_0, const my_Fp2 &ell_VW, const my_Fp2 &ell_VV,
+                                                 const my_Fp2 &ell2_0, const my_Fp2 &ell2_VW, const my_Fp2 &ell2_VV);
 
     static my_Fp6 mul_by_non_residue(const my_Fp6 &elt);
 
     template<mp_size_t m>
     Fp12_2over3over2_model cyclotomic_exp(const bigint<m> &exponent) const;
+    /* product of bases[i]^exponents[i] for bases in the cyclotomic subgroup, sharing the squarings (wNAF) */
+    template<mp_size_t m>
+    static Fp12_2over3over2_model cyclotomic_multi_exp(const std::vector<Fp12_2over3over2_model> &bases,
+                                                       const std::vector<bigint<m> > &exponents);
+    template<mp_size_t m>
+    Fp12_2over3over2_model cyclotomic_exp_compressed(const bigint<m> &exponent) const;
 
     static bigint<n> base_field_char() { return modulus; }
     static size_t extension_degree() { return 12; }
@@ -10,11 +10,20 @@
 #ifndef FP12_2OVER3OVER2_TCC_
 #define FP12_2OVER3OVER2_TCC_
 
+#include <algorithm>
+
+#include <libff/algebra/scalar_multiplication/wnaf.hpp>
+
 namespace libff {
 
 template<mp_size_t n, const bigint<n>& modulus>
 Fp6_3over2_model<n, modulus> Fp12_2over3over2_model<n,modulus>::mul_by_non_residue(const Fp6_3over2_model<n, modulus> &elt)
 {
+    if (my_Fp6::non_residue_c0 != 0 && non_residue == my_Fp6::non_residue)
+    {
+        return Fp6_3over2_model<n, modulus>(my_Fp6::mul_by_non_residue(elt.c2), elt.c0, elt.c1);
+    }
+
     return Fp6_3over2_model<n, modulus>(non_residue * elt.c2, elt.c0, elt.c1);
 }
 
@@ -186,15 +195,15 @@ Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::cyclotomic_
 
     // t0 + t1*y = (z0 + z1*y)^2 = a^2
     tmp = z0 * z1;
-    t0 = (z0 + z1) * (z0 + my_Fp6::non_residue * z1) - tmp - my_Fp6::non_residue * tmp;
+    t0 = (z0 + z1) * (z0 + my_Fp6::mul_by_non_residue(z1)) - tmp - my_Fp6::mul_by_non_residue(tmp);
     t1 = tmp + tmp;
     // t2 + t3*y = (z2 + z3*y)^2 = b^2
     tmp = z2 * z3;
-    t2 = (z2 + z3) * (z2 + my_Fp6::non_residue * z3) - tmp - my_Fp6::non_residue * tmp;
+    t2 = (z2 + z3) * (z2 + my_Fp6::mul_by_non_residue(z3)) - tmp - my_Fp6::mul_by_non_residue(tmp);
     t3 = tmp + tmp;
     // t4 + t5*y = (z4 + z5*y)^2 = c^2
     tmp = z4 * z5;
-    t4 = (z4 + z5) * (z4 + my_Fp6::non_residue * z5) - tmp - my_Fp6::non_residue * tmp;
+    t4 = (z4 + z5) * (z4 + my_Fp6::mul_by_non_residue(z5)) - tmp - my_Fp6::mul_by_non_residue(tmp);
     t5 = tmp + tmp;
 
     // for A
@@ -211,7 +220,7 @@ Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::cyclotomic_
     // for B
 
     // z2 = 3 * (xi * t5) + 2 * z2
-    tmp = my_Fp6::non_residue * t5;
+    tmp = my_Fp6::mul_by_non_residue(t5);
     z2 = tmp + z2;
     z2 = z2 + z2;
     z2 = z2 + tmp;
@@ -236,6 +245,104 @@ Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::cyclotomic_
     return Fp12_2over3over2_model<n,modulus>(my_Fp6(z0,z4,z3),my_Fp6(z2,z1,z5));
 }
 
+template<mp_size_t n, const bigint<n>& modulus>
+Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::cyclotomic_squared_compressed() const
+{
+    /* Karabina --- Squaring in cyclotomic subgroups; Section 3, with
+       g1 = c0.c1, g2 = c0.c2, g3 = c1.c0, g5 = c1.c2 */
+    const my_Fp2 &g1 = this->c0.c1;
+    const my_Fp2 &g2 = this->c0.c2;
+    const my_Fp2 &g3 = this->c1.c0;
+    const my_Fp2 &g5 = this->c1.c2;
+
+    const my_Fp2 g1sq = g1.squared();
+    const my_Fp2 g2sq = g2.squared();
+    const my_Fp2 g3sq = g3.squared();
+    const my_Fp2 g5sq = g5.squared();
+    const my_Fp2 g1g5 = (g1 + g5).squared() - g1sq - g5sq; // 2 * g1 * g5
+    const my_Fp2 g2g3 = (g2 + g3).squared() - g2sq - g3sq; // 2 * g2 * g3
+
+    my_Fp2 t, h1, h2, h3, h5;
+
+    // h1 = 3 * (g3^2 + xi * g2^2) - 2 * g1
+    t = g3sq + my_Fp6::mul_by_non_residue(g2sq);
+    h1 = t - g1;
+    h1 = h1 + h1 + t;
+
+    // h2 = 3 * (g1^2 + xi * g5^2) - 2 * g2
+    t = g1sq + my_Fp6::mul_by_non_residue(g5sq);
+    h2 = t - g2;
+    h2 = h2 + h2 + t;
+
+    // h3 = 3 * (xi * 2 * g1 * g5) + 2 * g3
+    t = my_Fp6::mul_by_non_residue(g1g5);
+    h3 = t + g3;
+    h3 = h3 + h3 + t;
+
+    // h5 = 3 * (2 * g2 * g3) + 2 * g5
+    h5 = g2g3 + g5;
+    h5 = h5 + h5 + g2g3;
+
+    return Fp12_2over3over2_model<n,modulus>(my_Fp6(my_Fp2::zero(), h1, h2),
+                                             my_Fp6(h3, my_Fp2::zero(), h5));
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+void Fp12_2over3over2_model<n,modulus>::decompress_cyclotomic(std::vector<Fp12_2over3over2_model<n,modulus> > &vec)
+{
+    /* g4 = num / den, where
+       num = xi * g5^2 + 3 * g1^2 - 2 * g2 and den = 4 * g3, or
+       num = 2 * g1 * g5 and den = g2 if g3 = 0 */
+    std::vector<my_Fp2> num(vec.size()), den(vec.size()), scratch(vec.size());
+    for (size_t i = 0; i < vec.size(); ++i)
+    {
+        const my_Fp2 &g1 = vec[i].c0.c1;
+        const my_Fp2 &g2 = vec[i].c0.c2;
+        const my_Fp2 &g3 = vec[i].c1.c0;
+        const my_Fp2 &g5 = vec[i].c1.c2;
+
+        if (g3.is_zero())
+        {
+            num[i] = g1 * g5;
+            num[i] = num[i] + num[i];
+            den[i] = g2;
+        }
+        else
+        {
+            const my_Fp2 g1sq = g1.squared();
+            num[i] = g1sq - g2;
+            num[i] = num[i] + num[i] + g1sq + my_Fp6::mul_by_non_residue(g5.squared());
+            den[i] = g3 + g3;
+            den[i] = den[i] + den[i];
+        }
+
+        /* only the identity has g2 = g3 = 0; there num = 0 and g4 = 0 */
+        if (den[i].is_zero())
+        {
+            den[i] = my_Fp2::one();
+        }
+    }
+
+    batch_invert(den.data(), den.size(), scratch.data());
+
+    for (size_t i = 0; i < vec.size(); ++i)
+    {
+        const my_Fp2 &g1 = vec[i].c0.c1;
+        const my_Fp2 &g2 = vec[i].c0.c2;
+        const my_Fp2 &g3 = vec[i].c1.c0;
+        const my_Fp2 &g5 = vec[i].c1.c2;
+
+        const my_Fp2 g4 = num[i] * den[i];
+        // g0 = xi * (2 * g4^2 + g3 * g5 - 3 * g1 * g2) + 1
+        const my_Fp2 g1g2 = g1 * g2;
+        my_Fp2 t = g4.squared() - g1g2;
+        t = t + t - g1g2 + g3 * g5;
+
+        vec[i].c0.c0 = my_Fp6::mul_by_non_residue(t) + my_Fp2::one();
+        vec[i].c1.c1 = g4;
+    }
+}
+
 template<mp_size_t n, const bigint<n>& modulus>
 Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::mul_by_024(const Fp2_model<n, modulus> &ell_0,
                                                                                 const Fp2_model<n, modulus> &ell_VW,
@@ -270,14 +377,14 @@ Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::mul_by_024(
     // For z.a_.a_ = z0.
     S1 = z1 * x2;
     T3 = S1 + D4;
-    T4 = my_Fp6::non_residue * T3 + D0;
+    T4 = my_Fp6::mul_by_non_residue(T3) + D0;
     z0 = T4;
 
     // For z.a_.b_ = z1
     T3 = z5 * x4;
     S1 = S1 + T3;
     T3 = T3 + D2;
-    T4 = my_Fp6::non_residue * T3;
+    T4 = my_Fp6::mul_by_non_residue(T3);
     T3 = z1 * x0;
     S1 = S1 + T3;
     T4 = T4 + T3;
@@ -295,7 +402,7 @@ Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::mul_by_024(
     z2 = T3;
     t1 = x2 + x4;
     T3 = t0 * t1 - D2 - D4;
-    T4 = my_Fp6::non_residue * T3;
+    T4 = my_Fp6::mul_by_non_residue(T3);
     T3 = z3 * x0;
     S1 = S1 + T3;
     T4 = T4 + T3;
@@ -304,7 +411,7 @@ Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::mul_by_024(
     // For z.b_.b_ = z4
     T3 = z5 * x2;
     S1 = S1 + T3;
-    T4 = my_Fp6::non_residue * T3;
+    T4 = my_Fp6::mul_by_non_residue(T3);
     t0 = x0 + x4;
     T3 = t2 * t0 - D0 - D4;
     T4 = T4 + T3;
@@ -319,6 +426,31 @@ Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::mul_by_024(
 
 }
 
+template<mp_size_t n, const bigint<n>& modulus>
+Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::mul_024_by_024(const Fp2_model<n, modulus> &ell_0,
+                                                                                    const Fp2_model<n, modulus> &ell_VW,
+                                                                                    const Fp2_model<n, modulus> &ell_VV,
+                                                                                    const Fp2_model<n, modulus> &ell2_0,
+                                                                                    const Fp2_model<n, modulus> &ell2_VW,
+                                                                                    const Fp2_model<n, modulus> &ell2_VV)
+{
+    /* (x0 + x2 V^2 + x4 V W) * (y0 + y2 V^2 + y4 V W), with W^2 = V and V^3 = non_residue */
+    const my_Fp2 &x0 = ell_0, &x2 = ell_VV, &x4 = ell_VW;
+    const my_Fp2 &y0 = ell2_0, &y2 = ell2_VV, &y4 = ell2_VW;
+
+    const my_Fp2 D0 = x0 * y0;
+    const my_Fp2 D2 = x2 * y2;
+    const my_Fp2 D4 = x4 * y4;
+
+    const my_Fp2 z0 = D0 + my_Fp6::mul_by_non_residue(D4);
+    const my_Fp2 z1 = my_Fp6::mul_by_non_residue(D2);
+    const my_Fp2 z2 = (x0 + x2) * (y0 + y2) - D0 - D2;
+    const my_Fp2 z3 = my_Fp6::mul_by_non_residue((x2 + x4) * (y2 + y4) - D2 - D4);
+    const my_Fp2 z4 = (x0 + x4) * (y0 + y4) - D0 - D4;
+
+    return Fp12_2over3over2_model<n,modulus>(my_Fp6(z0, z1, z2), my_Fp6(z3, z4, my_Fp2::zero()));
+}
+
 template<mp_size_t n, const bigint<n>& modulus, mp_size_t m>
 Fp12_2over3over2_model<n, modulus> operator^(const Fp12_2over3over2_model<n, modulus> &self, const bigint<m> &exponent)
 {
@@ -336,22 +468,60 @@ template<mp_size_t n, const bigint<n>& modulus>
 template<mp_size_t m>
 Fp12_2over3over2_model<n, modulus> Fp12_2over3over2_model<n,modulus>::cyclotomic_exp(const bigint<m> &exponent) const
 {
-    Fp12_2over3over2_model<n,modulus> res = Fp12_2over3over2_model<n,modulus>::one();
+    return Fp12_2over3over2_model<n,modulus>::cyclotomic_multi_exp(std::vector<Fp12_2over3over2_model<n,modulus> >(1, *this),
+                                                                   std::vector<bigint<m> >(1, exponent));
+}
 
-    bool found_one = false;
-    for (long i = m-1; i >= 0; --i)
+template<mp_size_t n, const bigint<n>& modulus>
+template<mp_size_t m>
+Fp12_2over3over2_model<n, modulus> Fp12_2over3over2_model<n,modulus>::cyclotomic_multi_exp(const std::vector<Fp12_2over3over2_model<n,modulus> > &bases,
+                                                                                            const std::vector<bigint<m> > &exponents)
+{
+    assert(bases.size() == exponents.size());
+
+    size_t max_bits = 0;
+    for (const bigint<m> &e : exponents)
+    {
+        max_bits = std::max(max_bits, e.num_bits());
+    }
+
+    /* wNAF digits are odd and below 2^window in absolute value; a digit d
+       multiplies by table[|d|/2] = base^|d|, or by its unitary inverse */
+    const size_t window = (max_bits < 32 ? 2 : (max_bits < 128 ? 3 : 4));
+    std::vector<std::vector<long> > nafs;
+    std::vector<std::vector<Fp12_2over3over2_model<n,modulus> > > tables;
+    nafs.reserve(bases.size());
+    tables.reserve(bases.size());
+    for (size_t j = 0; j < bases.size(); ++j)
     {
-        for (long j = GMP_NUMB_BITS - 1; j >= 0; --j)
+        nafs.emplace_back(find_wnaf(window, exponents[j]));
+
+        std::vector<Fp12_2over3over2_model<n,modulus> > table(1ul<<(window-1));
+        const Fp12_2over3over2_model<n,modulus> base_squared = bases[j].cyclotomic_squared();
+        table[0] = bases[j];
+        for (size_t i = 1; i < table.size(); ++i)
         {
-            if (found_one)
-            {
-                res = res.cyclotomic_squared();
-            }
+            table[i] = table[i-1] * base_squared;
+        }
+        tables.emplace_back(table);
+    }
 
-            if (exponent.data[i] & (1ul<<j))
+    Fp12_2over3over2_model<n,modulus> res = Fp12_2over3over2_model<n,modulus>::one();
+    bool found_nonzero = false;
+    for (long i = max_bits; i >= 0; --i)
+    {
+        if (found_nonzero)
+        {
+            res = res.cyclotomic_squared();
+        }
+
+        for (size_t j = 0; j < bases.size(); ++j)
+        {
+            const long d = nafs[j][i];
+            if (d != 0)
             {
-                found_one = true;
-                res = res * (*this);
+                found_nonzero = true;
+                res = res * (d > 0 ? tables[j][d/2] : tables[j][(-d)/2].unitary_inverse());
             }
         }
     }
@@ -359,6 +529,44 @@ Fp12_2over3over2_model<n, modulus> Fp12_2over3over2_model<n,modulus>::cyclotomic
     return res;
 }
 
+template<mp_size_t n, const bigint<n>& modulus>
+template<mp_size_t m>
+Fp12_2over3over2_model<n, modulus> Fp12_2over3over2_model<n,modulus>::cyclotomic_exp_compressed(const bigint<m> &exponent) const
+{
+    /* right-to-left: the squarings this^(2^i) are done compressed, and
+       the ones needed for the product are decompressed together */
+    const size_t bits = exponent.num_bits();
+    Fp12_2over3over2_model<n,modulus> res = Fp12_2over3over2_model<n,modulus>::one();
+    if (bits == 0)
+    {
+        return res;
+    }
+
+    if (exponent.test_bit(0))
+    {
+        res = *this;
+    }
+
+    std::vector<Fp12_2over3over2_model<n,modulus> > powers;
+    Fp12_2over3over2_model<n,modulus> x = *this;
+    for (size_t i = 1; i < bits; ++i)
+    {
+        x = x.cyclotomic_squared_compressed();
+        if (exponent.test_bit(i))
+        {
+            powers.emplace_back(x);
+        }
+    }
+
+    decompress_cyclotomic(powers);
+    for (const Fp12_2over3over2_model<n,modulus> &p : powers)
+    {
+        res = res * p;
+    }
+
+    return res;
+}
+
 template<mp_size_t n, const bigint<n>& modulus>
 std::ostream& operator<<(std::ostream &out, const Fp12_2over3over2_model<n, modulus> &el)
 {
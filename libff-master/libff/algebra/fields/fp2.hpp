@@ -45,6 +45,7 @@ public:
     static Fp2_model<n, modulus> nqr; // a quadratic nonresidue in Fp2
     static Fp2_model<n, modulus> nqr_to_t; // nqr^t
     static my_Fp Frobenius_coeffs_c1[2]; // non_residue^((modulus^i-1)/2) for i=0,1
+    static bool lazy_reduction; // non_residue == -1 and 4*modulus < R; set by init_lazy_reduction()
 
     my_Fp c0, c1;
     Fp2_model() {};
@@ -75,6 +76,16 @@ public:
     template<mp_size_t m>
     Fp2_model operator^(const bigint<m> &other) const;
 
+    /*
+      Lazy reduction (see Fp_model::mul_unreduced): unreduced products with
+      each coefficient a double-width integer below modulus * R. Only valid if
+      lazy_reduction is set; operator* and squared() then use them as well.
+    */
+    static void init_lazy_reduction(); // to be called once non_residue is set
+    static void mul_unreduced(bigint<2*n> &c0, bigint<2*n> &c1, const Fp2_model &x, const Fp2_model &y);
+    static void sqr_unreduced(bigint<2*n> &c0, bigint<2*n> &c1, const Fp2_model &x);
+    static Fp2_model montgomery_reduce(bigint<2*n> &c0, bigint<2*n> &c1); // overwrites c0, c1
+
     static size_t size_in_bits() { return 2*my_Fp::size_in_bits(); }
     static bigint<n> base_field_char() { return modulus; }
 
@@ -115,6 +126,9 @@ Fp2_model<n, modulus> Fp2_model<n, modulus>::nqr_to_t;
 template<mp_size_t n, const bigint<n>& modulus>
 Fp_model<n, modulus> Fp2_model<n, modulus>::Frobenius_coeffs_c1[2];
 
+template<mp_size_t n, const bigint<n>& modulus>
+bool Fp2_model<n, modulus>::lazy_reduction = false;
+
 } // libff
 #include <libff/algebra/fields/fp2.tcc>
 
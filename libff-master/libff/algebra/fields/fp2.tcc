@@ -72,6 +72,13 @@ Fp2_model<n, modulus> operator*(const Fp_model<n, modulus> &lhs, const Fp2_model
 template<mp_size_t n, const bigint<n>& modulus>
 Fp2_model<n,modulus> Fp2_model<n,modulus>::operator*(const Fp2_model<n,modulus> &other) const
 {
+    if (lazy_reduction)
+    {
+        bigint<2*n> c0, c1;
+        mul_unreduced(c0, c1, *this, other);
+        return montgomery_reduce(c0, c1);
+    }
+
     /* Devegili OhEig Scott Dahab --- Multiplication and Squaring on Pairing-Friendly Fields.pdf; Section 3 (Karatsuba) */
     const my_Fp
         &A = other.c0, &B = other.c1,
@@ -93,6 +100,13 @@ Fp2_model<n,modulus> Fp2_model<n,modulus>::operator-() const
 template<mp_size_t n, const bigint<n>& modulus>
 Fp2_model<n,modulus> Fp2_model<n,modulus>::squared() const
 {
+    if (lazy_reduction)
+    {
+        bigint<2*n> c0, c1;
+        sqr_unreduced(c0, c1, *this);
+        return montgomery_reduce(c0, c1);
+    }
+
     return squared_complex();
 }
 
@@ -119,6 +133,47 @@ Fp2_model<n,modulus> Fp2_model<n,modulus>::squared_complex() const
                                 ab + ab);
 }
 
+template<mp_size_t n, const bigint<n>& modulus>
+void Fp2_model<n,modulus>::init_lazy_reduction()
+{
+    /* sums of two reduced elements must stay below 2*modulus < R/2 */
+    const bool headroom = (modulus.data[n-1] >> (GMP_NUMB_BITS - 2)) == 0;
+    lazy_reduction = headroom && (non_residue == -my_Fp::one());
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+void Fp2_model<n,modulus>::mul_unreduced(bigint<2*n> &c0, bigint<2*n> &c1, const Fp2_model<n,modulus> &x, const Fp2_model<n,modulus> &y)
+{
+    /* Karatsuba with U^2 = -1: c0 = aA - bB, c1 = (a+b)(A+B) - aA - bB */
+    const my_Fp &A = y.c0, &B = y.c1,
+        &a = x.c0, &b = x.c1;
+    bigint<2*n> bB;
+    my_Fp::mul_unreduced(c0, a.mont_repr, A.mont_repr);
+    my_Fp::mul_unreduced(bB, b.mont_repr, B.mont_repr);
+    my_Fp::mul_unreduced(c1, my_Fp::sum_unreduced(a, b), my_Fp::sum_unreduced(A, B));
+
+    /* aB + bA is computed exactly and is below 2*modulus^2 */
+    mpn_sub_n(c1.data, c1.data, c0.data, 2*n);
+    mpn_sub_n(c1.data, c1.data, bB.data, 2*n);
+    my_Fp::sub_unreduced(c0, c0, bB);
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+void Fp2_model<n,modulus>::sqr_unreduced(bigint<2*n> &c0, bigint<2*n> &c1, const Fp2_model<n,modulus> &x)
+{
+    /* complex squaring with U^2 = -1: c0 = (a+b)(a-b), c1 = 2ab */
+    const my_Fp &a = x.c0, &b = x.c1;
+    my_Fp::mul_unreduced(c0, my_Fp::sum_unreduced(a, b), (a - b).mont_repr);
+    my_Fp::mul_unreduced(c1, my_Fp::sum_unreduced(a, a), b.mont_repr);
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+Fp2_model<n,modulus> Fp2_model<n,modulus>::montgomery_reduce(bigint<2*n> &c0, bigint<2*n> &c1)
+{
+    return Fp2_model<n,modulus>(my_Fp::montgomery_reduce(c0),
+                                my_Fp::montgomery_reduce(c1));
+}
+
 template<mp_size_t n, const bigint<n>& modulus>
 Fp2_model<n,modulus> Fp2_model<n,modulus>::inverse() const
 {
@@ -42,6 +42,8 @@ public:
     static my_Fp2 non_residue;
     static my_Fp2 Frobenius_coeffs_c1[6]; // non_residue^((modulus^i-1)/3)   for i=0,1,2,3,4,5
     static my_Fp2 Frobenius_coeffs_c2[6]; // non_residue^((2*modulus^i-2)/3) for i=0,1,2,3,4,5
+    static unsigned long non_residue_c0; // if nonzero, non_residue == non_residue_c0 + U with U^2 = -1 in Fp2
+    static bool lazy_reduction; // non_residue_c0 is nonzero and Fp2 lazy reduction is available
 
     my_Fp2 c0, c1, c2;
     Fp6_3over2_model() {};
@@ -68,6 +70,15 @@ public:
 
     static my_Fp2 mul_by_non_residue(const my_Fp2 &elt);
 
+    /*
+      Setting non_residue_c0 lets mul_by_non_residue use additions only, and
+      lazy_reduction lets operator* and squared() accumulate unreduced Fp2
+      products, with one Montgomery reduction per Fp coefficient of the result.
+    */
+    static void init_lazy_reduction(); // to be called once non_residue and Fp2 are set up
+    static my_Fp mul_by_small(const my_Fp &x, const unsigned long k);
+    static void mul_by_non_residue_unreduced(bigint<2*n> &c0, bigint<2*n> &c1);
+
     template<mp_size_t m>
     Fp6_3over2_model operator^(const bigint<m> &other) const;
 
@@ -99,6 +110,12 @@ Fp2_model<n, modulus> Fp6_3over2_model<n, modulus>::Frobenius_coeffs_c1[6];
 template<mp_size_t n, const bigint<n>& modulus>
 Fp2_model<n, modulus> Fp6_3over2_model<n, modulus>::Frobenius_coeffs_c2[6];
 
+template<mp_size_t n, const bigint<n>& modulus>
+unsigned long Fp6_3over2_model<n, modulus>::non_residue_c0 = 0;
+
+template<mp_size_t n, const bigint<n>& modulus>
+bool Fp6_3over2_model<n, modulus>::lazy_reduction = false;
+
 } // libff
 #include <libff/algebra/fields/fp6_3over2.tcc>
 
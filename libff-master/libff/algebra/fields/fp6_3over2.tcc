@@ -16,9 +16,67 @@ namespace libff {
 template<mp_size_t n, const bigint<n>& modulus>
 Fp2_model<n, modulus> Fp6_3over2_model<n,modulus>::mul_by_non_residue(const Fp2_model<n, modulus> &elt)
 {
+    if (non_residue_c0 != 0)
+    {
+        /* (k + U) * (x0 + x1 U) = (k x0 - x1) + (k x1 + x0) U */
+        return Fp2_model<n, modulus>(mul_by_small(elt.c0, non_residue_c0) - elt.c1,
+                                     mul_by_small(elt.c1, non_residue_c0) + elt.c0);
+    }
+
     return Fp2_model<n, modulus>(non_residue * elt);
 }
 
+template<mp_size_t n, const bigint<n>& modulus>
+void Fp6_3over2_model<n,modulus>::init_lazy_reduction()
+{
+    const bigint<n> c0 = non_residue.c0.as_bigint();
+    const bool small_c0 = (c0.num_bits() <= 8 && !c0.is_zero());
+
+    non_residue_c0 = 0;
+    if (small_c0 && non_residue.c1 == my_Fp::one() && my_Fp2::non_residue == -my_Fp::one())
+    {
+        non_residue_c0 = c0.as_ulong();
+    }
+    lazy_reduction = (non_residue_c0 != 0) && my_Fp2::lazy_reduction;
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+Fp_model<n, modulus> Fp6_3over2_model<n,modulus>::mul_by_small(const Fp_model<n, modulus> &x, const unsigned long k)
+{
+    /* left-to-right double-and-add; k > 0 */
+    my_Fp res = x;
+    for (long i = (long)(8*sizeof(k)) - __builtin_clzl(k) - 2; i >= 0; --i)
+    {
+        res = res + res;
+        if (k & (1ul << i))
+        {
+            res += x;
+        }
+    }
+    return res;
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+void Fp6_3over2_model<n,modulus>::mul_by_non_residue_unreduced(bigint<2*n> &c0, bigint<2*n> &c1)
+{
+    /* as mul_by_non_residue, on unreduced coefficients; requires non_residue_c0 != 0 */
+    const unsigned long k = non_residue_c0;
+    bigint<2*n> k0 = c0, k1 = c1;
+    for (long i = (long)(8*sizeof(k)) - __builtin_clzl(k) - 2; i >= 0; --i)
+    {
+        my_Fp::add_unreduced(k0, k0, k0);
+        my_Fp::add_unreduced(k1, k1, k1);
+        if (k & (1ul << i))
+        {
+            my_Fp::add_unreduced(k0, k0, c0);
+            my_Fp::add_unreduced(k1, k1, c1);
+        }
+    }
+    my_Fp::add_unreduced(k1, k1, c0);
+    my_Fp::sub_unreduced(c0, k0, c1);
+    c1 = k1;
+}
+
 template<mp_size_t n, const bigint<n>& modulus>
 Fp6_3over2_model<n,modulus> Fp6_3over2_model<n,modulus>::zero()
 {
@@ -93,6 +151,42 @@ Fp6_3over2_model<n,modulus> Fp6_3over2_model<n,modulus>::operator*(const Fp6_3ov
 
     const my_Fp2 &A = other.c0, &B = other.c1, &C = other.c2,
                  &a = this->c0, &b = this->c1, &c = this->c2;
+
+    if (lazy_reduction)
+    {
+        /* same formulas, on unreduced Fp2 products */
+        bigint<2*n> aA[2], bB[2], cC[2], r0[2], r1[2], r2[2];
+        my_Fp2::mul_unreduced(aA[0], aA[1], a, A);
+        my_Fp2::mul_unreduced(bB[0], bB[1], b, B);
+        my_Fp2::mul_unreduced(cC[0], cC[1], c, C);
+        my_Fp2::mul_unreduced(r0[0], r0[1], b+c, B+C);
+        my_Fp2::mul_unreduced(r1[0], r1[1], a+b, A+B);
+        my_Fp2::mul_unreduced(r2[0], r2[1], a+c, A+C);
+
+        for (size_t i = 0; i < 2; ++i)
+        {
+            my_Fp::sub_unreduced(r0[i], r0[i], bB[i]);
+            my_Fp::sub_unreduced(r0[i], r0[i], cC[i]);
+            my_Fp::sub_unreduced(r1[i], r1[i], aA[i]);
+            my_Fp::sub_unreduced(r1[i], r1[i], bB[i]);
+            my_Fp::sub_unreduced(r2[i], r2[i], aA[i]);
+            my_Fp::add_unreduced(r2[i], r2[i], bB[i]);
+            my_Fp::sub_unreduced(r2[i], r2[i], cC[i]);
+        }
+
+        mul_by_non_residue_unreduced(r0[0], r0[1]);
+        mul_by_non_residue_unreduced(cC[0], cC[1]);
+        for (size_t i = 0; i < 2; ++i)
+        {
+            my_Fp::add_unreduced(r0[i], r0[i], aA[i]);
+            my_Fp::add_unreduced(r1[i], r1[i], cC[i]);
+        }
+
+        return Fp6_3over2_model<n,modulus>(my_Fp2::montgomery_reduce(r0[0], r0[1]),
+                                           my_Fp2::montgomery_reduce(r1[0], r1[1]),
+                                           my_Fp2::montgomery_reduce(r2[0], r2[1]));
+    }
+
     const my_Fp2 aA = a*A;
     const my_Fp2 bB = b*B;
     const my_Fp2 cC = c*C;
@@ -116,6 +210,38 @@ Fp6_3over2_model<n,modulus> Fp6_3over2_model<n,modulus>::squared() const
     /* Devegili OhEig Scott Dahab --- Multiplication and Squaring on Pairing-Friendly Fields.pdf; Section 4 (CH-SQR2) */
 
     const my_Fp2 &a = this->c0, &b = this->c1, &c = this->c2;
+
+    if (lazy_reduction)
+    {
+        /* same formulas, on unreduced Fp2 products */
+        bigint<2*n> s0[2], s1[2], s2[2], s3[2], s4[2];
+        my_Fp2::sqr_unreduced(s0[0], s0[1], a);
+        my_Fp2::mul_unreduced(s1[0], s1[1], a+a, b);
+        my_Fp2::sqr_unreduced(s2[0], s2[1], a - b + c);
+        my_Fp2::mul_unreduced(s3[0], s3[1], b+b, c);
+        my_Fp2::sqr_unreduced(s4[0], s4[1], c);
+
+        for (size_t i = 0; i < 2; ++i)
+        {
+            my_Fp::add_unreduced(s2[i], s2[i], s1[i]);
+            my_Fp::add_unreduced(s2[i], s2[i], s3[i]);
+            my_Fp::sub_unreduced(s2[i], s2[i], s0[i]);
+            my_Fp::sub_unreduced(s2[i], s2[i], s4[i]);
+        }
+
+        mul_by_non_residue_unreduced(s3[0], s3[1]);
+        mul_by_non_residue_unreduced(s4[0], s4[1]);
+        for (size_t i = 0; i < 2; ++i)
+        {
+            my_Fp::add_unreduced(s0[i], s0[i], s3[i]);
+            my_Fp::add_unreduced(s1[i], s1[i], s4[i]);
+        }
+
+        return Fp6_3over2_model<n,modulus>(my_Fp2::montgomery_reduce(s0[0], s0[1]),
+                                           my_Fp2::montgomery_reduce(s1[0], s1[1]),
+                                           my_Fp2::montgomery_reduce(s2[0], s2[1]));
+    }
+
     const my_Fp2 s0 = a.squared();
     const my_Fp2 ab = a*b;
     const my_Fp2 s1 = ab + ab;
@@ -385,5 +385,272 @@ namespace libff {
          : [modprime] "r" (inv_), [res] "r" (res_), [mod] "r" (mod_) \
          : "%rax", "%rdx", "cc", "memory")
 
+/*
+  Comba squaring of 5-limb operands, following the same register
+  renaming scheme as COMBA_3_BY_3_SQR. Column k accumulates the products
+  A[i]*A[j] with i+j = k in (lo, mid, hi); a product with i < j is computed
+  once and added twice, which saves n(n-1)/2 of the n^2 multiplications.
+ */
+#define COMBA_SQR_CROSS(lo, mid, hi, i, j)               \
+    "movq  " STR((i*8)) "(%[A]), %%rax    \n\t"         \
+    "mulq  " STR((j*8)) "(%[A])           \n\t"         \
+    "addq  %%rax, %[" #lo "]              \n\t"         \
+    "adcq  %%rdx, %[" #mid "]             \n\t"         \
+    "adcq  $0, %[" #hi "]                 \n\t"         \
+    "addq  %%rax, %[" #lo "]              \n\t"         \
+    "adcq  %%rdx, %[" #mid "]             \n\t"         \
+    "adcq  $0, %[" #hi "]                 \n\t"
+
+#define COMBA_SQR_DIAG(lo, mid, hi, i)                   \
+    "movq  " STR((i*8)) "(%[A]), %%rax    \n\t"         \
+    "mulq  %%rax                          \n\t"         \
+    "addq  %%rax, %[" #lo "]              \n\t"         \
+    "adcq  %%rdx, %[" #mid "]             \n\t"         \
+    "adcq  $0, %[" #hi "]                 \n\t"
+
+/* store column k and clear its register, which becomes the next hi */
+#define COMBA_SQR_STORE(lo, k)                           \
+    "movq  %[" #lo "], " STR((k*8)) "(%[res]) \n\t"     \
+    "xorq  %[" #lo "], %[" #lo "]         \n\t"
+
+#define COMBA_5_BY_5_SQR(c0_, c1_, c2_, res_, A_)        \
+    asm volatile (                                      \
+        "xorq  %[c0], %[c0]               \n\t"         \
+        "xorq  %[c1], %[c1]               \n\t"         \
+        "xorq  %[c2], %[c2]               \n\t"         \
+        COMBA_SQR_DIAG(c0, c1, c2, 0)                   \
+        COMBA_SQR_STORE(c0, 0)                          \
+        COMBA_SQR_CROSS(c1, c2, c0, 0, 1)               \
+        COMBA_SQR_STORE(c1, 1)                          \
+        COMBA_SQR_CROSS(c2, c0, c1, 0, 2)               \
+        COMBA_SQR_DIAG(c2, c0, c1, 1)                   \
+        COMBA_SQR_STORE(c2, 2)                          \
+        COMBA_SQR_CROSS(c0, c1, c2, 0, 3)               \
+        COMBA_SQR_CROSS(c0, c1, c2, 1, 2)               \
+        COMBA_SQR_STORE(c0, 3)                          \
+        COMBA_SQR_CROSS(c1, c2, c0, 0, 4)               \
+        COMBA_SQR_CROSS(c1, c2, c0, 1, 3)               \
+        COMBA_SQR_DIAG(c1, c2, c0, 2)                   \
+        COMBA_SQR_STORE(c1, 4)                          \
+        COMBA_SQR_CROSS(c2, c0, c1, 1, 4)               \
+        COMBA_SQR_CROSS(c2, c0, c1, 2, 3)               \
+        COMBA_SQR_STORE(c2, 5)                          \
+        COMBA_SQR_CROSS(c0, c1, c2, 2, 4)               \
+        COMBA_SQR_DIAG(c0, c1, c2, 3)                   \
+        COMBA_SQR_STORE(c0, 6)                          \
+        COMBA_SQR_CROSS(c1, c2, c0, 3, 4)               \
+        COMBA_SQR_STORE(c1, 7)                          \
+        COMBA_SQR_DIAG(c2, c0, c1, 4)                   \
+        COMBA_SQR_STORE(c2, 8)                          \
+        "movq  %[c0], 72(%[res])          \n\t"         \
+                                                        \
+        : [c0] "=&r" (c0_), [c1] "=&r" (c1_), [c2] "=&r" (c2_) \
+        : [res] "r" (res_), [A] "r" (A_)                \
+        : "%rax", "%rdx", "cc", "memory")
+
+/*
+  Comba multiplication of 4- and 5-limb operands, using the column
+  accumulation and register renaming of the squaring routines above.
+ */
+#define COMBA_MUL_TERM(lo, mid, hi, i, j)                \
+    "movq  " STR((i*8)) "(%[A]), %%rax    \n\t"         \
+    "mulq  " STR((j*8)) "(%[B])           \n\t"         \
+    "addq  %%rax, %[" #lo "]              \n\t"         \
+    "adcq  %%rdx, %[" #mid "]             \n\t"         \
+    "adcq  $0, %[" #hi "]                 \n\t"
+
+#define COMBA_4_BY_4_MUL(c0_, c1_, c2_, res_, A_, B_)    \
+    asm volatile (                                  \
+        "xorq  %[c0], %[c0]               \n\t"     \
+        "xorq  %[c1], %[c1]               \n\t"     \
+        "xorq  %[c2], %[c2]               \n\t"     \
+        COMBA_MUL_TERM(c0, c1, c2, 0, 0)            \
+        COMBA_SQR_STORE(c0, 0)                      \
+        COMBA_MUL_TERM(c1, c2, c0, 0, 1)            \
+        COMBA_MUL_TERM(c1, c2, c0, 1, 0)            \
+        COMBA_SQR_STORE(c1, 1)                      \
+        COMBA_MUL_TERM(c2, c0, c1, 0, 2)            \
+        COMBA_MUL_TERM(c2, c0, c1, 1, 1)            \
+        COMBA_MUL_TERM(c2, c0, c1, 2, 0)            \
+        COMBA_SQR_STORE(c2, 2)                      \
+        COMBA_MUL_TERM(c0, c1, c2, 0, 3)            \
+        COMBA_MUL_TERM(c0, c1, c2, 1, 2)            \
+        COMBA_MUL_TERM(c0, c1, c2, 2, 1)            \
+        COMBA_MUL_TERM(c0, c1, c2, 3, 0)            \
+        COMBA_SQR_STORE(c0, 3)                      \
+        COMBA_MUL_TERM(c1, c2, c0, 1, 3)            \
+        COMBA_MUL_TERM(c1, c2, c0, 2, 2)            \
+        COMBA_MUL_TERM(c1, c2, c0, 3, 1)            \
+        COMBA_SQR_STORE(c1, 4)                      \
+        COMBA_MUL_TERM(c2, c0, c1, 2, 3)            \
+        COMBA_MUL_TERM(c2, c0, c1, 3, 2)            \
+        COMBA_SQR_STORE(c2, 5)                      \
+        COMBA_MUL_TERM(c0, c1, c2, 3, 3)            \
+        COMBA_SQR_STORE(c0, 6)                      \
+        "movq  %[c1], 56(%[res])          \n\t"     \
+                                                    \
+        : [c0] "=&r" (c0_), [c1] "=&r" (c1_), [c2] "=&r" (c2_) \
+        : [res] "r" (res_), [A] "r" (A_), [B] "r" (B_) \
+        : "%rax", "%rdx", "cc", "memory")
+
+#define COMBA_5_BY_5_MUL(c0_, c1_, c2_, res_, A_, B_)    \
+    asm volatile (                                  \
+        "xorq  %[c0], %[c0]               \n\t"     \
+        "xorq  %[c1], %[c1]               \n\t"     \
+        "xorq  %[c2], %[c2]               \n\t"     \
+        COMBA_MUL_TERM(c0, c1, c2, 0, 0)            \
+        COMBA_SQR_STORE(c0, 0)                      \
+        COMBA_MUL_TERM(c1, c2, c0, 0, 1)            \
+        COMBA_MUL_TERM(c1, c2, c0, 1, 0)            \
+        COMBA_SQR_STORE(c1, 1)                      \
+        COMBA_MUL_TERM(c2, c0, c1, 0, 2)            \
+        COMBA_MUL_TERM(c2, c0, c1, 1, 1)            \
+        COMBA_MUL_TERM(c2, c0, c1, 2, 0)            \
+        COMBA_SQR_STORE(c2, 2)                      \
+        COMBA_MUL_TERM(c0, c1, c2, 0, 3)            \
+        COMBA_MUL_TERM(c0, c1, c2, 1, 2)            \
+        COMBA_MUL_TERM(c0, c1, c2, 2, 1)            \
+        COMBA_MUL_TERM(c0, c1, c2, 3, 0)            \
+        COMBA_SQR_STORE(c0, 3)                      \
+        COMBA_MUL_TERM(c1, c2, c0, 0, 4)            \
+        COMBA_MUL_TERM(c1, c2, c0, 1, 3)            \
+        COMBA_MUL_TERM(c1, c2, c0, 2, 2)            \
+        COMBA_MUL_TERM(c1, c2, c0, 3, 1)            \
+        COMBA_MUL_TERM(c1, c2, c0, 4, 0)            \
+        COMBA_SQR_STORE(c1, 4)                      \
+        COMBA_MUL_TERM(c2, c0, c1, 1, 4)            \
+        COMBA_MUL_TERM(c2, c0, c1, 2, 3)            \
+        COMBA_MUL_TERM(c2, c0, c1, 3, 2)            \
+        COMBA_MUL_TERM(c2, c0, c1, 4, 1)            \
+        COMBA_SQR_STORE(c2, 5)                      \
+        COMBA_MUL_TERM(c0, c1, c2, 2, 4)            \
+        COMBA_MUL_TERM(c0, c1, c2, 3, 3)            \
+        COMBA_MUL_TERM(c0, c1, c2, 4, 2)            \
+        COMBA_SQR_STORE(c0, 6)                      \
+        COMBA_MUL_TERM(c1, c2, c0, 3, 4)            \
+        COMBA_MUL_TERM(c1, c2, c0, 4, 3)            \
+        COMBA_SQR_STORE(c1, 7)                      \
+        COMBA_MUL_TERM(c2, c0, c1, 4, 4)            \
+        COMBA_SQR_STORE(c2, 8)                      \
+        "movq  %[c0], 72(%[res])          \n\t"     \
+                                                    \
+        : [c0] "=&r" (c0_), [c1] "=&r" (c1_), [c2] "=&r" (c2_) \
+        : [res] "r" (res_), [A] "r" (A_), [B] "r" (B_) \
+        : "%rax", "%rdx", "cc", "memory")
+
+/*
+  Montgomery reduction of a 2n-limb product in place (Algorithm 14.32 of
+  HAC, as REDUCE_6_LIMB_PRODUCT), one row i at a time: res += k * mod * b^i
+  with k = res[i] * inv. Afterwards res[n..2n-1] holds the result, < 2*mod.
+ */
+#define REDUCE_ROW_START(i)                              \
+    "movq  " STR((i*8)) "(%[res]), %%rax  \n\t"         \
+    "mulq  %[modprime]                    \n\t"         \
+    "movq  %%rax, %[k]                    \n\t"         \
+    "xorq  %[c], %[c]                     \n\t"
+
+/* res[i+j] += k * mod[j] + c, c <- carry limb */
+#define REDUCE_ROW_STEP(i, j)                            \
+    "movq  " STR((j*8)) "(%[mod]), %%rax  \n\t"         \
+    "mulq  %[k]                           \n\t"         \
+    "addq  %[c], %%rax                    \n\t"         \
+    "adcq  $0, %%rdx                      \n\t"         \
+    "addq  %%rax, " STR(((i+j)*8)) "(%[res]) \n\t"      \
+    "adcq  $0, %%rdx                      \n\t"         \
+    "movq  %%rdx, %[c]                    \n\t"
+
+#define REDUCE_ROW_END(l)                                \
+    "addq  %[c], " STR((l*8)) "(%[res])   \n\t"
+
+#define REDUCE_ROW_CARRY(l)                              \
+    "adcq  $0, " STR((l*8)) "(%[res])     \n\t"
+
+#define REDUCE_8_LIMB_PRODUCT(k_, c_, inv_, res_, mod_)  \
+    __asm__ volatile (                                  \
+        REDUCE_ROW_START(0)                             \
+        REDUCE_ROW_STEP(0, 0)                           \
+        REDUCE_ROW_STEP(0, 1)                           \
+        REDUCE_ROW_STEP(0, 2)                           \
+        REDUCE_ROW_STEP(0, 3)                           \
+        REDUCE_ROW_END(4)                               \
+        REDUCE_ROW_CARRY(5)                             \
+        REDUCE_ROW_CARRY(6)                             \
+        REDUCE_ROW_CARRY(7)                             \
+        REDUCE_ROW_START(1)                             \
+        REDUCE_ROW_STEP(1, 0)                           \
+        REDUCE_ROW_STEP(1, 1)                           \
+        REDUCE_ROW_STEP(1, 2)                           \
+        REDUCE_ROW_STEP(1, 3)                           \
+        REDUCE_ROW_END(5)                               \
+        REDUCE_ROW_CARRY(6)                             \
+        REDUCE_ROW_CARRY(7)                             \
+        REDUCE_ROW_START(2)                             \
+        REDUCE_ROW_STEP(2, 0)                           \
+        REDUCE_ROW_STEP(2, 1)                           \
+        REDUCE_ROW_STEP(2, 2)                           \
+        REDUCE_ROW_STEP(2, 3)                           \
+        REDUCE_ROW_END(6)                               \
+        REDUCE_ROW_CARRY(7)                             \
+        REDUCE_ROW_START(3)                             \
+        REDUCE_ROW_STEP(3, 0)                           \
+        REDUCE_ROW_STEP(3, 1)                           \
+        REDUCE_ROW_STEP(3, 2)                           \
+        REDUCE_ROW_STEP(3, 3)                           \
+        REDUCE_ROW_END(7)                               \
+        : [k] "=&r" (k_), [c] "=&r" (c_)                \
+        : [modprime] "r" (inv_), [res] "r" (res_), [mod] "r" (mod_) \
+        : "%rax", "%rdx", "cc", "memory")
+
+#define REDUCE_10_LIMB_PRODUCT(k_, c_, inv_, res_, mod_) \
+    __asm__ volatile (                                  \
+        REDUCE_ROW_START(0)                             \
+        REDUCE_ROW_STEP(0, 0)                           \
+        REDUCE_ROW_STEP(0, 1)                           \
+        REDUCE_ROW_STEP(0, 2)                           \
+        REDUCE_ROW_STEP(0, 3)                           \
+        REDUCE_ROW_STEP(0, 4)                           \
+        REDUCE_ROW_END(5)                               \
+        REDUCE_ROW_CARRY(6)                             \
+        REDUCE_ROW_CARRY(7)                             \
+        REDUCE_ROW_CARRY(8)                             \
+        REDUCE_ROW_CARRY(9)                             \
+        REDUCE_ROW_START(1)                             \
+        REDUCE_ROW_STEP(1, 0)                           \
+        REDUCE_ROW_STEP(1, 1)                           \
+        REDUCE_ROW_STEP(1, 2)                           \
+        REDUCE_ROW_STEP(1, 3)                           \
+        REDUCE_ROW_STEP(1, 4)                           \
+        REDUCE_ROW_END(6)                               \
+        REDUCE_ROW_CARRY(7)                             \
+        REDUCE_ROW_CARRY(8)                             \
+        REDUCE_ROW_CARRY(9)                             \
+        REDUCE_ROW_START(2)                             \
+        REDUCE_ROW_STEP(2, 0)                           \
+        REDUCE_ROW_STEP(2, 1)                           \
+        REDUCE_ROW_STEP(2, 2)                           \
+        REDUCE_ROW_STEP(2, 3)                           \
+        REDUCE_ROW_STEP(2, 4)                           \
+        REDUCE_ROW_END(7)                               \
+        REDUCE_ROW_CARRY(8)                             \
+        REDUCE_ROW_CARRY(9)                             \
+        REDUCE_ROW_START(3)                             \
+        REDUCE_ROW_STEP(3, 0)                           \
+        REDUCE_ROW_STEP(3, 1)                           \
+        REDUCE_ROW_STEP(3, 2)                           \
+        REDUCE_ROW_STEP(3, 3)                           \
+        REDUCE_ROW_STEP(3, 4)                           \
+        REDUCE_ROW_END(8)                               \
+        REDUCE_ROW_CARRY(9)                             \
+        REDUCE_ROW_START(4)                             \
+        REDUCE_ROW_STEP(4, 0)                           \
+        REDUCE_ROW_STEP(4, 1)                           \
+        REDUCE_ROW_STEP(4, 2)                           \
+        REDUCE_ROW_STEP(4, 3)                           \
+        REDUCE_ROW_STEP(4, 4)                           \
+        REDUCE_ROW_END(9)                               \
+        : [k] "=&r" (k_), [c] "=&r" (c_)                \
+        : [modprime] "r" (inv_), [res] "r" (res_), [mod] "r" (mod_) \
+        : "%rax", "%rdx", "cc", "memory")
+
 } // libff
 #endif // FP_AUX_TCC_
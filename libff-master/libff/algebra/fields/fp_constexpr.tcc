@@ -0,0 +1,174 @@
+/** @file
+ *****************************************************************************
+ F[p] arithmetic specialized for a modulus known at compile time, used by
+ Fp_model in fp.tcc when fp_constexpr_params is specialized for its modulus.
+ Requires 64-bit limbs and unsigned __int128.
+
+ The modulus, inv and limb count being constants, the loops below are
+ unrolled and the modulus limbs folded into the instructions. Montgomery
+ multiplication uses the CIOS method without the extra carry word, which is
+ valid when the top limb of the modulus is below 2^63 - 2, as the
+ intermediate values then fit in n limbs.
+ *****************************************************************************
+ * @author     This file is part of libff, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef FP_CONSTEXPR_TCC_
+#define FP_CONSTEXPR_TCC_
+
+namespace libff {
+
+/* stubs for moduli without compile-time parameters, never called */
+template<mp_size_t n, typename Params, bool available = Params::available>
+struct fp_constexpr_arith {
+    static void mul(mp_limb_t *, const mp_limb_t *, const mp_limb_t *) {}
+    static void sqr(mp_limb_t *, const mp_limb_t *) {}
+    static void add(mp_limb_t *, const mp_limb_t *, const mp_limb_t *) {}
+    static void sub(mp_limb_t *, const mp_limb_t *, const mp_limb_t *) {}
+};
+
+#ifdef __SIZEOF_INT128__
+template<mp_size_t n, typename Params>
+struct fp_constexpr_arith<n, Params, true> {
+    typedef unsigned __int128 dlimb;
+
+    static_assert(GMP_NUMB_BITS == 64, "compile-time moduli require 64-bit limbs");
+    static_assert(Params::modulus.data[n-1] < (~(mp_limb_t)0 >> 1) - 1,
+                  "the top limb of the modulus must leave a spare bit");
+
+    /* res = t - modulus if t >= modulus, else t */
+    static inline void reduce_once(mp_limb_t *res, const mp_limb_t *t)
+    {
+        mp_limb_t d[n];
+        mp_limb_t borrow = 0;
+#pragma GCC unroll 8
+        for (mp_size_t j = 0; j < n; ++j)
+        {
+            const dlimb s = (dlimb)t[j] - Params::modulus.data[j] - borrow;
+            d[j] = (mp_limb_t)s;
+            borrow = (mp_limb_t)(s >> GMP_NUMB_BITS) & 1;
+        }
+#pragma GCC unroll 8
+        for (mp_size_t j = 0; j < n; ++j)
+        {
+            res[j] = (borrow ? t[j] : d[j]);
+        }
+    }
+
+    /* res = a * b * R^(-1) mod modulus; res may alias a or b */
+    static inline void mul(mp_limb_t *res, const mp_limb_t *a, const mp_limb_t *b)
+    {
+        mp_limb_t t[n] = {0};
+#pragma GCC unroll 8
+        for (mp_size_t i = 0; i < n; ++i)
+        {
+            dlimb s = (dlimb)a[0] * b[i] + t[0];
+            mp_limb_t carry_ab = (mp_limb_t)(s >> GMP_NUMB_BITS);
+            t[0] = (mp_limb_t)s;
+
+            const mp_limb_t k = t[0] * Params::inv;
+            s = (dlimb)k * Params::modulus.data[0] + t[0];
+            mp_limb_t carry_km = (mp_limb_t)(s >> GMP_NUMB_BITS);
+
+#pragma GCC unroll 8
+            for (mp_size_t j = 1; j < n; ++j)
+            {
+                s = (dlimb)a[j] * b[i] + t[j] + carry_ab;
+                carry_ab = (mp_limb_t)(s >> GMP_NUMB_BITS);
+                s = (dlimb)k * Params::modulus.data[j] + (mp_limb_t)s + carry_km;
+                carry_km = (mp_limb_t)(s >> GMP_NUMB_BITS);
+                t[j-1] = (mp_limb_t)s;
+            }
+            t[n-1] = carry_ab + carry_km;
+        }
+        reduce_once(res, t);
+    }
+
+    /*
+      res = a^2 * R^(-1) mod modulus; res may alias a. As mul, but row i only
+      multiplies a[i] by the limbs j >= i of a: each cross product a[i]*a[j]
+      is taken once against 2 * (limbs j > i of a), shifted limb by limb, which
+      fits in n - i limbs as a < modulus.
+    */
+    static inline void sqr(mp_limb_t *res, const mp_limb_t *a)
+    {
+        mp_limb_t t[n+1] = {0};
+#pragma GCC unroll 8
+        for (mp_size_t i = 0; i < n; ++i)
+        {
+            dlimb s = (dlimb)a[i] * a[i] + t[i];
+            t[i] = (mp_limb_t)s;
+            mp_limb_t carry = (mp_limb_t)(s >> GMP_NUMB_BITS);
+            mp_limb_t shifted_out = 0;
+#pragma GCC unroll 8
+            for (mp_size_t j = i + 1; j < n; ++j)
+            {
+                s = (dlimb)a[i] * ((a[j] << 1) | shifted_out) + t[j] + carry;
+                shifted_out = a[j] >> (GMP_NUMB_BITS - 1);
+                t[j] = (mp_limb_t)s;
+                carry = (mp_limb_t)(s >> GMP_NUMB_BITS);
+            }
+            t[n] += carry;
+
+            const mp_limb_t k = t[0] * Params::inv;
+            s = (dlimb)k * Params::modulus.data[0] + t[0];
+            carry = (mp_limb_t)(s >> GMP_NUMB_BITS);
+#pragma GCC unroll 8
+            for (mp_size_t j = 1; j < n; ++j)
+            {
+                s = (dlimb)k * Params::modulus.data[j] + t[j] + carry;
+                t[j-1] = (mp_limb_t)s;
+                carry = (mp_limb_t)(s >> GMP_NUMB_BITS);
+            }
+            s = (dlimb)t[n] + carry;
+            t[n-1] = (mp_limb_t)s;
+            t[n] = (mp_limb_t)(s >> GMP_NUMB_BITS);
+        }
+        reduce_once(res, t);
+    }
+
+    /* res = a + b mod modulus; no carry out of n limbs, as 2 * modulus < 2^(64n) */
+    static inline void add(mp_limb_t *res, const mp_limb_t *a, const mp_limb_t *b)
+    {
+        mp_limb_t t[n];
+        mp_limb_t carry = 0;
+#pragma GCC unroll 8
+        for (mp_size_t j = 0; j < n; ++j)
+        {
+            const dlimb s = (dlimb)a[j] + b[j] + carry;
+            t[j] = (mp_limb_t)s;
+            carry = (mp_limb_t)(s >> GMP_NUMB_BITS);
+        }
+        reduce_once(res, t);
+    }
+
+    /* res = a - b mod modulus */
+    static inline void sub(mp_limb_t *res, const mp_limb_t *a, const mp_limb_t *b)
+    {
+        mp_limb_t t[n];
+        mp_limb_t borrow = 0;
+#pragma GCC unroll 8
+        for (mp_size_t j = 0; j < n; ++j)
+        {
+            const dlimb s = (dlimb)a[j] - b[j] - borrow;
+            t[j] = (mp_limb_t)s;
+            borrow = (mp_limb_t)(s >> GMP_NUMB_BITS) & 1;
+        }
+        const mp_limb_t mask = -borrow;
+        mp_limb_t carry = 0;
+#pragma GCC unroll 8
+        for (mp_size_t j = 0; j < n; ++j)
+        {
+            const dlimb s = (dlimb)t[j] + (Params::modulus.data[j] & mask) + carry;
+            res[j] = (mp_limb_t)s;
+            carry = (mp_limb_t)(s >> GMP_NUMB_BITS);
+        }
+    }
+};
+#endif
+
+} // libff
+
+#endif // FP_CONSTEXPR_TCC_
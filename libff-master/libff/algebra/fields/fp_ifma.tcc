@@ -0,0 +1,167 @@
+/** @file
+ *****************************************************************************
+ AVX-512 IFMA kernel for 8-way F[p] Montgomery multiplication, used by
+ batch_mul in fp.tcc .
+ Specific to x86-64 with 4-limb moduli, and used only if USE_ASM is defined
+ and the CPU reports AVX-512 IFMA support at runtime.
+
+ Each of the 8 lanes holds one field element in radix 2^52 (5 limbs).
+ The kernel runs CIOS Montgomery multiplication with R' = 2^260, and
+ pre-scales one operand by 2^4 so that the lane results are Montgomery
+ products for the usual R = 2^256 used by Fp_model<4, modulus>.
+ *****************************************************************************
+ * @author     This file is part of libff, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef FP_IFMA_TCC_
+#define FP_IFMA_TCC_
+
+#if defined(__x86_64__) && defined(USE_ASM)
+#include <immintrin.h>
+
+namespace libff {
+
+inline bool cpu_supports_avx512_ifma()
+{
+    static const bool supported = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512ifma");
+    return supported;
+}
+
+#define IFMA_TARGET __attribute__((target("avx512f,avx512ifma")))
+
+/*
+  Shifts and gathers use the zero-masking forms with all 8 lanes enabled: the
+  plain forms merge into _mm512_undefined_epi32(), which GCC reports as used
+  uninitialized.
+*/
+#define IFMA_SHL(x, n) _mm512_maskz_slli_epi64(0xFF, x, n)
+#define IFMA_SHR(x, n) _mm512_maskz_srli_epi64(0xFF, x, n)
+
+/* split 4 x 64-bit limbs into 5 x 52-bit limbs */
+IFMA_TARGET inline void ifma_to_radix52(__m512i l[5], const __m512i x[4])
+{
+    const __m512i mask52 = _mm512_set1_epi64(0xFFFFFFFFFFFFFll);
+    l[0] = _mm512_and_si512(x[0], mask52);
+    l[1] = _mm512_and_si512(_mm512_or_si512(IFMA_SHR(x[0], 52), IFMA_SHL(x[1], 12)), mask52);
+    l[2] = _mm512_and_si512(_mm512_or_si512(IFMA_SHR(x[1], 40), IFMA_SHL(x[2], 24)), mask52);
+    l[3] = _mm512_and_si512(_mm512_or_si512(IFMA_SHR(x[2], 28), IFMA_SHL(x[3], 36)), mask52);
+    l[4] = IFMA_SHR(x[3], 16);
+}
+
+/* join 5 x 52-bit limbs (value < 2^256) into 4 x 64-bit limbs */
+IFMA_TARGET inline void ifma_from_radix52(__m512i x[4], const __m512i l[5])
+{
+    x[0] = _mm512_or_si512(l[0], IFMA_SHL(l[1], 52));
+    x[1] = _mm512_or_si512(IFMA_SHR(l[1], 12), IFMA_SHL(l[2], 40));
+    x[2] = _mm512_or_si512(IFMA_SHR(l[2], 24), IFMA_SHL(l[3], 28));
+    x[3] = _mm512_or_si512(IFMA_SHR(l[3], 36), IFMA_SHL(l[4], 16));
+}
+
+/*
+  out[i] = a[i] * b[i] * 2^(-256) mod p for the 8 elements i = 0..7, where
+  element i starts at limb offset i*stride of each of out, a, b.
+  Requires p < 2^256, odd, and a[i], b[i] < p. out may alias a or b.
+*/
+IFMA_TARGET inline void mont_mul_4_ifma_x8(mp_limb_t *out, const mp_limb_t *a, const mp_limb_t *b, const size_t stride,
+                                           const mp_limb_t *mod, const mp_limb_t inv)
+{
+    const __m512i mask52 = _mm512_set1_epi64(0xFFFFFFFFFFFFFll);
+    const __m512i zero = _mm512_setzero_si512();
+    const long long s = stride;
+    const __m512i idx = _mm512_set_epi64(7*s, 6*s, 5*s, 4*s, 3*s, 2*s, s, 0);
+
+    __m512i x[4], A[5], B[5], P[5], T[6];
+
+    for (size_t k = 0; k < 4; ++k)
+    {
+        x[k] = _mm512_mask_i64gather_epi64(zero, 0xFF, idx, (const void*)(a + k), 8);
+    }
+    ifma_to_radix52(A, x);
+    for (size_t k = 0; k < 4; ++k)
+    {
+        x[k] = _mm512_mask_i64gather_epi64(zero, 0xFF, idx, (const void*)(b + k), 8);
+    }
+    ifma_to_radix52(B, x);
+    for (size_t k = 0; k < 4; ++k)
+    {
+        x[k] = _mm512_set1_epi64(mod[k]);
+    }
+    ifma_to_radix52(P, x);
+    const __m512i vinv = _mm512_set1_epi64(inv & 0xFFFFFFFFFFFFFull); // -p^(-1) mod 2^52
+
+    /* A <- 2^4 * A, which stays below 2^260 and needs no reduction */
+    A[4] = _mm512_or_si512(IFMA_SHL(A[4], 4), IFMA_SHR(A[3], 48));
+    for (size_t j = 3; j > 0; --j)
+    {
+        A[j] = _mm512_or_si512(_mm512_and_si512(IFMA_SHL(A[j], 4), mask52), IFMA_SHR(A[j-1], 48));
+    }
+    A[0] = _mm512_and_si512(IFMA_SHL(A[0], 4), mask52);
+
+    for (size_t j = 0; j < 6; ++j)
+    {
+        T[j] = zero;
+    }
+
+    for (size_t i = 0; i < 5; ++i)
+    {
+        for (size_t j = 0; j < 5; ++j)
+        {
+            T[j] = _mm512_madd52lo_epu64(T[j], A[j], B[i]);
+            T[j+1] = _mm512_madd52hi_epu64(T[j+1], A[j], B[i]);
+        }
+
+        const __m512i m = _mm512_madd52lo_epu64(zero, T[0], vinv);
+        for (size_t j = 0; j < 5; ++j)
+        {
+            T[j] = _mm512_madd52lo_epu64(T[j], P[j], m);
+            T[j+1] = _mm512_madd52hi_epu64(T[j+1], P[j], m);
+        }
+
+        /* low 52 bits of T[0] are now zero; shift down by one limb */
+        T[0] = _mm512_add_epi64(T[1], IFMA_SHR(T[0], 52));
+        for (size_t j = 1; j < 5; ++j)
+        {
+            T[j] = T[j+1];
+        }
+        T[5] = zero;
+    }
+
+    /* normalize; the result is below 2p */
+    for (size_t j = 0; j < 4; ++j)
+    {
+        T[j+1] = _mm512_add_epi64(T[j+1], IFMA_SHR(T[j], 52));
+        T[j] = _mm512_and_si512(T[j], mask52);
+    }
+
+    /* subtract p in lanes where T >= p */
+    __m512i D[5];
+    __m512i borrow = zero;
+    for (size_t j = 0; j < 5; ++j)
+    {
+        const __m512i d = _mm512_sub_epi64(_mm512_sub_epi64(T[j], P[j]), borrow);
+        borrow = IFMA_SHR(d, 63);
+        D[j] = _mm512_and_si512(d, mask52);
+    }
+    const __mmask8 no_borrow = _mm512_cmpeq_epi64_mask(borrow, zero);
+    for (size_t j = 0; j < 5; ++j)
+    {
+        T[j] = _mm512_mask_blend_epi64(no_borrow, T[j], D[j]);
+    }
+
+    ifma_from_radix52(x, T);
+    for (size_t k = 0; k < 4; ++k)
+    {
+        _mm512_i64scatter_epi64((void*)(out + k), idx, x[k], 8);
+    }
+}
+
+#undef IFMA_SHR
+#undef IFMA_SHL
+#undef IFMA_TARGET
+
+} // libff
+#endif // defined(__x86_64__) && defined(USE_ASM)
+
+#endif // FP_IFMA_TCC_
@@ -0,0 +1,267 @@
+/** @file
+ *****************************************************************************
+ Implementation of runtime-generated (JIT) arithmetic routines for F[p].
+
+ See fp_jit.hpp .
+ *****************************************************************************
+ * @author     This file is part of libff, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#include <memory>
+#include <vector>
+
+#define XBYAK_NO_OP_NAMES
+#include <depends/xbyak/xbyak/xbyak.h>
+#include <depends/xbyak/xbyak/xbyak_util.h>
+
+#include <libff/algebra/fields/fp_jit.hpp>
+
+namespace libff {
+
+using namespace Xbyak;
+
+class fp_jit_code : public CodeGenerator {
+private:
+    const int n;
+    Label L_mod; // n limbs of the modulus, followed by inv
+
+    Address mod_limb(const int i) { return qword[rip + L_mod + 8*i]; }
+
+    void push_callee_saved()
+    {
+        push(rbx); push(rbp); push(r12); push(r13); push(r14); push(r15);
+    }
+
+    void pop_callee_saved()
+    {
+        pop(r15); pop(r14); pop(r13); pop(r12); pop(rbp); pop(rbx);
+    }
+
+    /* t[0..n-1] <- t[0..n-1] - p if t[0..n] >= p, using scratch s[0..n-1] */
+    void reduce_once(const std::vector<Reg64> &t, const Reg64 &top, const std::vector<Reg64> &s)
+    {
+        for (int j = 0; j < n; ++j)
+        {
+            mov(s[j], t[j]);
+        }
+        sub(s[0], mod_limb(0));
+        for (int j = 1; j < n; ++j)
+        {
+            sbb(s[j], mod_limb(j));
+        }
+        sbb(top, 0);
+        for (int j = 0; j < n; ++j)
+        {
+            cmovnc(t[j], s[j]);
+        }
+    }
+
+    /*
+      CIOS Montgomery multiplication. The two carry chains of each row are
+      interleaved on CF (adcx) and OF (adox); t is rotated after each
+      reduction step at generation time instead of moving registers.
+    */
+    void gen_mul(const bool square)
+    {
+        const Reg64 &pz = rdi, &px = rsi, &py = rcx;
+        push_callee_saved();
+        push(pz);
+        if (square)
+        {
+            mov(py, px);
+        }
+        else
+        {
+            mov(py, rdx);
+        }
+
+        const Reg64 pool[] = { r8, r9, r10, r11, r12, r13, r14, r15, rbx, rbp, rdi, rax };
+        std::vector<Reg64> t(pool, pool + n + 2);
+        const Reg64 &lo = pool[n+2], &hi = pool[n+3], &zero = pool[n+4];
+
+        xor_(zero, zero);
+        for (int j = 0; j < n + 2; ++j)
+        {
+            mov(t[j], zero);
+        }
+
+        for (int i = 0; i < n; ++i)
+        {
+            /* t += x * y[i] */
+            mov(rdx, qword[py + 8*i]);
+            xor_(lo, lo);
+            for (int j = 0; j < n; ++j)
+            {
+                mulx(hi, lo, qword[px + 8*j]);
+                adox(t[j], lo);
+                adcx(t[j+1], hi);
+            }
+            adox(t[n], zero);
+            adcx(t[n+1], zero);
+            adox(t[n+1], zero);
+
+            /* t += (t[0] * inv mod W) * p, which clears t[0] */
+            mov(rdx, t[0]);
+            imul(rdx, mod_limb(n));
+            xor_(lo, lo);
+            for (int j = 0; j < n; ++j)
+            {
+                mulx(hi, lo, mod_limb(j));
+                adox(t[j], lo);
+                adcx(t[j+1], hi);
+            }
+            adox(t[n], zero);
+            adcx(t[n+1], zero);
+            adox(t[n+1], zero);
+
+            /* t /= W */
+            const Reg64 cleared = t[0];
+            t.erase(t.begin());
+            t.push_back(cleared);
+        }
+
+        /* t < 2p; subtract p once if needed */
+        const Reg64 scratch[] = { lo, hi, rdx, rcx, rsi };
+        reduce_once(t, t[n], std::vector<Reg64>(scratch, scratch + n));
+
+        pop(pz);
+        for (int j = 0; j < n; ++j)
+        {
+            mov(qword[pz + 8*j], t[j]);
+        }
+        pop_callee_saved();
+        ret();
+    }
+
+    void gen_add()
+    {
+        const Reg64 &pz = rdi, &px = rsi, &py = rdx;
+        push_callee_saved();
+
+        const Reg64 pool[] = { rax, rcx, r8, r9, r10, r11, r12, r13, r14, r15, rbx, rbp };
+        const std::vector<Reg64> t(pool, pool + n), s(pool + n, pool + 2*n);
+        const Reg64 &top = pool[2*n];
+
+        for (int j = 0; j < n; ++j)
+        {
+            mov(t[j], qword[px + 8*j]);
+        }
+        mov(top, 0);
+        add(t[0], qword[py]);
+        for (int j = 1; j < n; ++j)
+        {
+            adc(t[j], qword[py + 8*j]);
+        }
+        adc(top, 0);
+
+        reduce_once(t, top, s);
+
+        for (int j = 0; j < n; ++j)
+        {
+            mov(qword[pz + 8*j], t[j]);
+        }
+        pop_callee_saved();
+        ret();
+    }
+
+    void gen_sub()
+    {
+        const Reg64 &pz = rdi, &px = rsi, &py = rdx;
+        push_callee_saved();
+
+        const Reg64 pool[] = { rax, rcx, r8, r9, r10, r11, r12, r13, r14, r15, rbx, rbp };
+        const std::vector<Reg64> t(pool, pool + n), s(pool + n, pool + 2*n);
+        const Reg64 &mask = pool[2*n];
+
+        for (int j = 0; j < n; ++j)
+        {
+            mov(t[j], qword[px + 8*j]);
+        }
+        sub(t[0], qword[py]);
+        for (int j = 1; j < n; ++j)
+        {
+            sbb(t[j], qword[py + 8*j]);
+        }
+        /* add back p if the subtraction borrowed */
+        sbb(mask, mask);
+        for (int j = 0; j < n; ++j)
+        {
+            mov(s[j], mod_limb(j));
+            and_(s[j], mask);
+        }
+        add(t[0], s[0]);
+        for (int j = 1; j < n; ++j)
+        {
+            adc(t[j], s[j]);
+        }
+
+        for (int j = 0; j < n; ++j)
+        {
+            mov(qword[pz + 8*j], t[j]);
+        }
+        pop_callee_saved();
+        ret();
+    }
+
+    fp_jit_op entry()
+    {
+        align(16);
+        return reinterpret_cast<fp_jit_op>(const_cast<uint8*>(getCurr()));
+    }
+
+public:
+    fp_jit_code(const mp_size_t num_limbs, const mp_limb_t *mod, const mp_limb_t inv, fp_jit_routines &routines) :
+        CodeGenerator(4096), n(num_limbs)
+    {
+        L(L_mod);
+        for (int j = 0; j < n; ++j)
+        {
+            dq(mod[j]);
+        }
+        dq(inv);
+
+        fp_jit_routines res;
+        res.mul = entry();
+        gen_mul(false);
+        res.sqr = entry();
+        gen_mul(true);
+        res.add = entry();
+        gen_add();
+        res.sub = entry();
+        gen_sub();
+
+        routines = res;
+    }
+};
+
+bool fp_jit_generate(fp_jit_routines &routines, const mp_size_t n, const mp_limb_t *mod, const mp_limb_t inv)
+{
+    /* the generated code is kept for the lifetime of the program */
+    static std::vector<std::unique_ptr<fp_jit_code> > generated;
+
+    if (sizeof(mp_limb_t) != 8 || n < 3 || n > 5)
+    {
+        return false;
+    }
+
+    const util::Cpu cpu;
+    if (!cpu.has(util::Cpu::tBMI2) || !cpu.has(util::Cpu::tADX))
+    {
+        return false;
+    }
+
+    try
+    {
+        generated.emplace_back(new fp_jit_code(n, mod, inv, routines));
+    }
+    catch (const Xbyak::Error &)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+} // libff
@@ -0,0 +1,47 @@
+/** @file
+ *****************************************************************************
+ Declaration of runtime-generated (JIT) arithmetic routines for F[p].
+
+ The routines are generated with xbyak (see depends/xbyak) once the modulus
+ of an Fp_model is known, i.e. in the init_*_params() functions. They are
+ fully unrolled and specialized to the modulus, and use MULX/ADCX/ADOX.
+ Used by fp.tcc only if USE_JIT is defined.
+ *****************************************************************************
+ * @author     This file is part of libff, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef FP_JIT_HPP_
+#define FP_JIT_HPP_
+
+#include <gmp.h>
+
+namespace libff {
+
+typedef void (*fp_jit_op)(mp_limb_t *res, const mp_limb_t *a, const mp_limb_t *b);
+
+/**
+ * Entry points of the generated routines, all null if no code was generated.
+ * Operands and results are n-limb Montgomery representations, reduced
+ * modulo p; res may alias a or b.
+ */
+struct fp_jit_routines {
+    fp_jit_op mul; // res = a * b * R^(-1) mod p
+    fp_jit_op sqr; // res = a * a * R^(-1) mod p, b is not read
+    fp_jit_op add; // res = a + b mod p
+    fp_jit_op sub; // res = a - b mod p
+};
+
+/**
+ * Generate the routines for the n-limb modulus mod, with
+ * inv = -mod^(-1) mod 2^64.
+ *
+ * Returns false, leaving routines untouched, if the CPU lacks BMI2/ADX,
+ * if n is not in [3, 5], or if code generation fails.
+ */
+bool fp_jit_generate(fp_jit_routines &routines, const mp_size_t n, const mp_limb_t *mod, const mp_limb_t inv);
+
+} // libff
+
+#endif // FP_JIT_HPP_
@@ -0,0 +1,280 @@
+/** @file
+ *****************************************************************************
+ Constant-time F[p] inversion with the Bernstein-Yang "safegcd" algorithm,
+ used by Fp_model::invert_ct in fp.tcc .
+
+ Follows "Fast constant-time gcd computation and modular inversion"
+ (Bernstein, Yang; 2019). Integers are held in signed radix 2^62 limbs;
+ divsteps are applied in batches of 57 on the low 64 bits only, and the
+ accumulated 2x2 transition matrix is then applied to the full-width
+ values. The number of batches only depends on the bit length of the
+ modulus, and no step branches on secret data.
+
+ Requires 64-bit limbs and a compiler with __int128.
+ *****************************************************************************
+ * @author     This file is part of libff, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef FP_SAFEGCD_TCC_
+#define FP_SAFEGCD_TCC_
+
+#if defined(__SIZEOF_INT128__) && GMP_NUMB_BITS == 64
+#include <cstdint>
+
+namespace libff {
+
+const uint64_t safegcd_mask62 = UINT64_MAX >> 2;
+
+/* transition matrix of a batch of divsteps, scaled by 2^62 */
+struct safegcd_matrix {
+    int64_t u, v, q, r;
+};
+
+/*
+  19 divsteps on the low 19 bits of f (odd) and g, packed together with
+  their transition matrix rows: F = f + 2^21 u + 2^42 v, G = g + 2^21 q + 2^42 r,
+  starting from u = r = 2^19 and v = q = 0. Each divstep is then a handful of
+  word operations. All fields stay in (-2^20, 2^20), and the low field and
+  matrix entries stay exact as long as their halving is.
+*/
+inline int64_t safegcd_divsteps_19(int64_t delta, const uint64_t f, const uint64_t g, safegcd_matrix &t)
+{
+    const int64_t mask19 = (1ll << 19) - 1;
+    int64_t F = (int64_t)(f & mask19) + (1ll << (21 + 19));
+    int64_t G = (int64_t)(g & mask19) + (1ll << (42 + 19));
+
+    for (size_t i = 0; i < 19; ++i)
+    {
+        const int64_t c1 = (-delta) >> 63; // delta > 0
+        const int64_t c2 = -(G & 1); // g odd
+
+        /* if delta > 0 and g odd: (delta, f, g) <- (1 - delta, g, (g - f)/2),
+           otherwise: (delta, f, g) <- (1 + delta, f, (g + (g mod 2) f)/2) */
+        const int64_t x = (F ^ c1) - c1;
+        G += x & c2;
+        const int64_t swap = c1 & c2;
+        delta = (delta ^ swap) - swap + 1;
+        F += G & swap;
+        G >>= 1;
+    }
+
+    /* unpack; the biases make the two low fields non-negative */
+    const int64_t bias = (1ll << 20) + (1ll << 41);
+    F += bias;
+    G += bias;
+    t.u = ((F >> 21) & ((1ll << 21) - 1)) - (1ll << 20);
+    t.v = F >> 42;
+    t.q = ((G >> 21) & ((1ll << 21) - 1)) - (1ll << 20);
+    t.r = G >> 42;
+    return delta;
+}
+
+/*
+  57 divsteps on the low 64 bits of f (odd) and g, as three packed batches of
+  19. Returns the new delta, and t such that 2^62 * [f', g'] = t * [f, g] for
+  the full values.
+*/
+inline int64_t safegcd_divsteps_57(int64_t delta, uint64_t f, uint64_t g, safegcd_matrix &t)
+{
+    int64_t u = 1, v = 0, q = 0, r = 1;
+    for (size_t j = 0; j < 3; ++j)
+    {
+        safegcd_matrix s;
+        delta = safegcd_divsteps_19(delta, f, g, s);
+
+        /* the low 64 - 19*(j+1) bits of f and g stay exact */
+        const uint64_t fn = ((uint64_t)s.u * f + (uint64_t)s.v * g) >> 19;
+        const uint64_t gn = ((uint64_t)s.q * f + (uint64_t)s.r * g) >> 19;
+        f = fn;
+        g = gn;
+
+        const int64_t un = s.u * u + s.v * q, vn = s.u * v + s.v * r;
+        const int64_t qn = s.q * u + s.r * q, rn = s.q * v + s.r * r;
+        u = un; v = vn; q = qn; r = rn;
+    }
+
+    t.u = u * 32; t.v = v * 32;
+    t.q = q * 32; t.r = r * 32;
+    return delta;
+}
+
+/* [f, g] <- t * [f, g] / 2^62, which is exact */
+template<size_t L>
+inline void safegcd_update_fg(int64_t f[L], int64_t g[L], const safegcd_matrix &t)
+{
+    __int128 cf = (__int128)t.u * f[0] + (__int128)t.v * g[0];
+    __int128 cg = (__int128)t.q * f[0] + (__int128)t.r * g[0];
+    cf >>= 62;
+    cg >>= 62;
+    for (size_t i = 1; i < L; ++i)
+    {
+        cf += (__int128)t.u * f[i] + (__int128)t.v * g[i];
+        cg += (__int128)t.q * f[i] + (__int128)t.r * g[i];
+        f[i-1] = (int64_t)((uint64_t)cf & safegcd_mask62);
+        g[i-1] = (int64_t)((uint64_t)cg & safegcd_mask62);
+        cf >>= 62;
+        cg >>= 62;
+    }
+    f[L-1] = (int64_t)cf;
+    g[L-1] = (int64_t)cg;
+}
+
+/*
+  [d, e] <- t * [d, e] / 2^62 mod modulus, keeping both in (-2*modulus, modulus).
+  mod_inv62 is modulus^(-1) mod 2^62.
+*/
+template<size_t L>
+inline void safegcd_update_de(int64_t d[L], int64_t e[L], const safegcd_matrix &t,
+                              const int64_t mod62[L], const uint64_t mod_inv62)
+{
+    /* add [u, q] * modulus if d < 0 and [v, r] * modulus if e < 0 */
+    const int64_t sd = d[L-1] >> 63, se = e[L-1] >> 63;
+    int64_t md = (t.u & sd) + (t.v & se);
+    int64_t me = (t.q & sd) + (t.r & se);
+
+    __int128 cd = (__int128)t.u * d[0] + (__int128)t.v * e[0];
+    __int128 ce = (__int128)t.q * d[0] + (__int128)t.r * e[0];
+
+    /* then adjust md, me so that the low 62 bits of the result vanish */
+    md -= (int64_t)((mod_inv62 * (uint64_t)cd + (uint64_t)md) & safegcd_mask62);
+    me -= (int64_t)((mod_inv62 * (uint64_t)ce + (uint64_t)me) & safegcd_mask62);
+    cd += (__int128)mod62[0] * md;
+    ce += (__int128)mod62[0] * me;
+    cd >>= 62;
+    ce >>= 62;
+
+    for (size_t i = 1; i < L; ++i)
+    {
+        cd += (__int128)t.u * d[i] + (__int128)t.v * e[i] + (__int128)mod62[i] * md;
+        ce += (__int128)t.q * d[i] + (__int128)t.r * e[i] + (__int128)mod62[i] * me;
+        d[i-1] = (int64_t)((uint64_t)cd & safegcd_mask62);
+        e[i-1] = (int64_t)((uint64_t)ce & safegcd_mask62);
+        cd >>= 62;
+        ce >>= 62;
+    }
+    d[L-1] = (int64_t)cd;
+    e[L-1] = (int64_t)ce;
+}
+
+/* r in (-2*modulus, modulus) <- (sign < 0 ? -r : r) mod modulus, in [0, modulus) */
+template<size_t L>
+inline void safegcd_normalize(int64_t r[L], const int64_t sign, const int64_t mod62[L])
+{
+    const int64_t negate = sign >> 63;
+    int64_t add = r[L-1] >> 63;
+    for (size_t i = 0; i < L; ++i)
+    {
+        r[i] += mod62[i] & add;
+        r[i] = (r[i] ^ negate) - negate;
+    }
+    for (size_t i = 0; i + 1 < L; ++i)
+    {
+        r[i+1] += r[i] >> 62;
+        r[i] &= safegcd_mask62;
+    }
+
+    add = r[L-1] >> 63;
+    for (size_t i = 0; i < L; ++i)
+    {
+        r[i] += mod62[i] & add;
+    }
+    for (size_t i = 0; i + 1 < L; ++i)
+    {
+        r[i+1] += r[i] >> 62;
+        r[i] &= safegcd_mask62;
+    }
+}
+
+template<mp_size_t n, size_t L>
+inline void safegcd_to_signed62(int64_t r[L], const mp_limb_t *x)
+{
+    unsigned __int128 acc = 0;
+    int acc_bits = 0;
+    mp_size_t j = 0;
+    for (size_t i = 0; i < L; ++i)
+    {
+        if (acc_bits < 62 && j < n)
+        {
+            acc |= ((unsigned __int128)x[j++]) << acc_bits;
+            acc_bits += 64;
+        }
+        r[i] = (int64_t)((uint64_t)acc & safegcd_mask62);
+        acc >>= 62;
+        acc_bits -= 62;
+    }
+}
+
+template<mp_size_t n, size_t L>
+inline void safegcd_from_signed62(mp_limb_t *x, const int64_t r[L])
+{
+    unsigned __int128 acc = 0;
+    int acc_bits = 0;
+    size_t i = 0;
+    for (mp_size_t j = 0; j < n; ++j)
+    {
+        while (acc_bits < 64 && i < L)
+        {
+            acc |= ((unsigned __int128)(uint64_t)r[i++]) << acc_bits;
+            acc_bits += 62;
+        }
+        x[j] = (mp_limb_t)acc;
+        acc >>= 64;
+        acc_bits -= 64;
+    }
+}
+
+/*
+  res = x^(-1) mod modulus, for 0 < x < modulus with modulus odd and of
+  mod_bits bits, and inv = -modulus^(-1) mod 2^64 (as Fp_model::inv).
+  res may alias x.
+*/
+template<mp_size_t n>
+void safegcd_invert(mp_limb_t *res, const mp_limb_t *x, const mp_limb_t *mod, const mp_limb_t inv, const size_t mod_bits)
+{
+    /* room for values in (-2*modulus, modulus) */
+    static const size_t L = (64 * n + 2 + 61) / 62;
+
+    int64_t mod62[L], f[L], g[L], d[L], e[L];
+    safegcd_to_signed62<n, L>(mod62, mod);
+    safegcd_to_signed62<n, L>(g, x);
+    for (size_t i = 0; i < L; ++i)
+    {
+        f[i] = mod62[i];
+        d[i] = 0;
+        e[i] = 0;
+    }
+    e[0] = 1;
+    const uint64_t mod_inv62 = (0 - (uint64_t)inv) & safegcd_mask62;
+
+    /* divstep bound of Bernstein-Yang, Theorem 11.2 */
+    const size_t divsteps = (mod_bits < 46 ? (49 * mod_bits + 80) / 17 : (49 * mod_bits + 57) / 17);
+
+    /* invariants: d * x = f and e * x = g (mod modulus) */
+    int64_t delta = 1;
+    for (size_t i = 0; i < (divsteps + 56) / 57; ++i)
+    {
+        safegcd_matrix t;
+        const uint64_t f_lo = (uint64_t)f[0] | ((uint64_t)f[1] << 62);
+        const uint64_t g_lo = (uint64_t)g[0] | ((uint64_t)g[1] << 62);
+        delta = safegcd_divsteps_57(delta, f_lo, g_lo, t);
+        safegcd_update_de<L>(d, e, t, mod62, mod_inv62);
+        safegcd_update_fg<L>(f, g, t);
+    }
+
+    /* now g = 0 and f = gcd(x, modulus) = +-1 */
+#ifndef NDEBUG
+    for (size_t i = 0; i < L; ++i)
+    {
+        assert(g[i] == 0);
+    }
+#endif
+    safegcd_normalize<L>(d, f[L-1], mod62);
+    safegcd_from_signed62<n, L>(res, d);
+}
+
+} // libff
+#endif // defined(__SIZEOF_INT128__) && GMP_NUMB_BITS == 64
+
+#endif // FP_SAFEGCD_TCC_
@@ -4,6 +4,8 @@
  *             and contributors (see AUTHORS).
  * @copyright  MIT license (see LICENSE file)
  *****************************************************************************/
+#include <limits>
+
 #include <libff/algebra/curves/edwards/edwards_pp.hpp>
 #include <libff/algebra/curves/mnt/mnt4/mnt4_pp.hpp>
 #include <libff/algebra/curves/mnt/mnt6/mnt6_pp.hpp>
@@ -96,6 +98,172 @@ void test_unitary_inverse()
     assert(aqcubed_minus1.inverse() == aqcubed_minus1.unitary_inverse());
 }
 
+template<typename FieldT>
+void test_inverse()
+{
+    /* compare against Fermat's little theorem, x^(p-2) */
+    bigint<FieldT::num_limbs> p_minus_2 = FieldT::field_char();
+    mpn_sub_1(p_minus_2.data, p_minus_2.data, FieldT::num_limbs, 2);
+
+    std::vector<FieldT> v = { FieldT::one(), -FieldT::one(), FieldT(2), -FieldT(2) };
+    for (size_t i = 0; i < 20; ++i)
+    {
+        v.emplace_back(FieldT::random_element());
+    }
+
+    std::vector<FieldT> w = v, prod(v.size());
+    for (size_t i = 0; i < v.size(); ++i)
+    {
+        assert(v[i].inverse() == (v[i] ^ p_minus_2));
+        assert(v[i] * v[i].inverse() == FieldT::one());
+        assert(v[i].inverse_ct() == v[i].inverse());
+    }
+
+    batch_invert(w.data(), w.size(), prod.data());
+    for (size_t i = 0; i < v.size(); ++i)
+    {
+        assert(w[i] == v[i].inverse());
+    }
+}
+
+template<typename FieldT>
+void test_modular_arithmetic()
+{
+    /* compare against GMP on the standard representations, including
+       operands at the edges of the range, where conditional subtractions happen */
+    std::vector<FieldT> v = { FieldT::zero(), FieldT::one(), FieldT(2), -FieldT::one(), -FieldT(2) };
+    for (size_t i = 0; i < 10; ++i)
+    {
+        v.emplace_back(FieldT::random_element());
+    }
+
+    mpz_t p, x, y, r;
+    mpz_inits(p, x, y, r, NULL);
+    FieldT::field_char().to_mpz(p);
+
+    for (const FieldT &a : v)
+    {
+        a.as_bigint().to_mpz(x);
+
+        mpz_mul(r, x, x);
+        mpz_mod(r, r, p);
+        assert(a.squared().as_bigint() == bigint<FieldT::num_limbs>(r));
+
+        for (const FieldT &b : v)
+        {
+            b.as_bigint().to_mpz(y);
+
+            mpz_mul(r, x, y);
+            mpz_mod(r, r, p);
+            assert((a * b).as_bigint() == bigint<FieldT::num_limbs>(r));
+
+            mpz_add(r, x, y);
+            mpz_mod(r, r, p);
+            assert((a + b).as_bigint() == bigint<FieldT::num_limbs>(r));
+
+            mpz_sub(r, x, y);
+            mpz_mod(r, r, p);
+            assert((a - b).as_bigint() == bigint<FieldT::num_limbs>(r));
+        }
+    }
+
+    mpz_clears(p, x, y, r, NULL);
+}
+
+template<typename FieldT>
+void test_batch_mul()
+{
+    for (size_t len = 0; len <= 19; ++len)
+    {
+        std::vector<FieldT> a(len), b(len), c;
+        for (size_t i = 0; i < len; ++i)
+        {
+            a[i] = FieldT::random_element();
+            b[i] = FieldT::random_element();
+        }
+        if (len > 2)
+        {
+            a[0] = FieldT::zero();
+            b[1] = FieldT::one();
+            a[2] = -FieldT::one();
+            b[2] = -FieldT::one();
+        }
+
+        batch_mul(a, b, c);
+        assert(c.size() == len);
+        for (size_t i = 0; i < len; ++i)
+        {
+            assert(c[i] == a[i] * b[i]);
+        }
+
+        /* in-place */
+        batch_mul(a.data(), b.data(), a.data(), len);
+        assert(a == c);
+    }
+}
+
+template<typename Fp12T>
+void test_lazy_reduction()
+{
+    typedef typename Fp12T::my_Fp2 Fp2T;
+    typedef typename Fp12T::my_Fp6 Fp6T;
+    assert(Fp2T::lazy_reduction && Fp6T::lazy_reduction);
+
+    std::vector<Fp2T> x2, y2, r2;
+    std::vector<Fp6T> x6, y6, r6;
+    std::vector<Fp12T> x12, y12, r12;
+    for (size_t i = 0; i < 10; ++i)
+    {
+        x2.emplace_back(Fp2T::random_element()); y2.emplace_back(Fp2T::random_element());
+        x6.emplace_back(Fp6T::random_element()); y6.emplace_back(Fp6T::random_element());
+        x12.emplace_back(Fp12T::random_element()); y12.emplace_back(Fp12T::random_element());
+    }
+    /* operands at the top of the range */
+    x2[0] = -Fp2T::one(); y2[0] = Fp2T(-Fp2T::my_Fp::one(), -Fp2T::my_Fp::one());
+    x6[0] = Fp6T(y2[0], y2[0], y2[0]); y6[0] = x6[0];
+
+    for (size_t pass = 0; pass < 2; ++pass)
+    {
+        const bool lazy = (pass == 0);
+        if (!lazy)
+        {
+            Fp2T::lazy_reduction = false;
+            Fp6T::lazy_reduction = false;
+        }
+        for (size_t i = 0; i < x2.size(); ++i)
+        {
+            const Fp2T p2[] = { x2[i] * y2[i], x2[i].squared() };
+            const Fp6T p6[] = { x6[i] * y6[i], x6[i].squared() };
+            const Fp12T p12[] = { x12[i] * y12[i], x12[i].squared(), x12[i].cyclotomic_squared() };
+            if (lazy)
+            {
+                r2.insert(r2.end(), p2, p2 + 2);
+                r6.insert(r6.end(), p6, p6 + 2);
+                r12.insert(r12.end(), p12, p12 + 3);
+            }
+            else
+            {
+                assert(p2[0] == r2[2*i] && p2[1] == r2[2*i+1]);
+                assert(p6[0] == r6[2*i] && p6[1] == r6[2*i+1]);
+                assert(p12[0] == r12[3*i] && p12[1] == r12[3*i+1] && p12[2] == r12[3*i+2]);
+            }
+        }
+    }
+
+    /* also check the additions-only mul_by_non_residue against the generic one */
+    const unsigned long non_residue_c0 = Fp6T::non_residue_c0;
+    for (size_t i = 0; i < x2.size(); ++i)
+    {
+        const Fp2T fast = Fp6T::mul_by_non_residue(x2[i]);
+        Fp6T::non_residue_c0 = 0;
+        assert(fast == Fp6T::mul_by_non_residue(x2[i]));
+        Fp6T::non_residue_c0 = non_residue_c0;
+    }
+
+    Fp2T::lazy_reduction = true;
+    Fp6T::lazy_reduction = true;
+}
+
 template<typename FieldT>
 void test_cyclotomic_squaring();
 
@@ -135,6 +303,71 @@ void test_cyclotomic_squaring<Fqk<mnt6_pp> >()
     assert(beta.cyclotomic_squared() == beta.squared());
 }
 
+template<>
+void test_cyclotomic_squaring<Fqk<alt_bn128_pp> >()
+{
+    typedef Fqk<alt_bn128_pp> FieldT;
+    FieldT a = FieldT::random_element();
+    FieldT a_unitary = a.Frobenius_map(FieldT::extension_degree()/2) * a.inverse();
+    // beta = a^((q^(k/2)-1)*(q^2+1))
+    FieldT beta = a_unitary.Frobenius_map(2) * a_unitary;
+    assert(beta.cyclotomic_squared() == beta.squared());
+
+    std::vector<FieldT> compressed(1, beta.cyclotomic_squared_compressed());
+    compressed.emplace_back(compressed.back().cyclotomic_squared_compressed());
+    compressed.emplace_back(FieldT::one().cyclotomic_squared_compressed());
+    FieldT::decompress_cyclotomic(compressed);
+    assert(compressed[0] == beta.squared());
+    assert(compressed[1] == beta.squared().squared());
+    assert(compressed[2] == FieldT::one());
+
+    const bigint<alt_bn128_Fr::num_limbs> e = alt_bn128_Fr::random_element().as_bigint();
+    assert(beta.cyclotomic_exp_compressed(e) == beta.cyclotomic_exp(e));
+    assert(beta.cyclotomic_exp_compressed(bigint<1>(0ul)) == FieldT::one());
+    assert(beta.cyclotomic_exp_compressed(bigint<1>(1ul)) == beta);
+}
+
+#ifdef CURVE_BN128
+template<typename FieldT>
+void test_bn128_ate_field()
+{
+    test_field<FieldT>();
+    test_sqrt<FieldT>();
+
+    std::vector<FieldT> v, w;
+    for (size_t i = 0; i < 20; ++i)
+    {
+        v.emplace_back(FieldT::random_element());
+    }
+    w = v;
+    batch_invert<FieldT>(w);
+    for (size_t i = 0; i < v.size(); ++i)
+    {
+        assert(w[i] * v[i] == FieldT::one());
+    }
+}
+
+void test_bn128_ate_Fq_conversion()
+{
+    const long small[] = { 0, 1, -1, 1l << 31, -(1l << 31) - 1, 1l << 40, -(1l << 40),
+                           std::numeric_limits<long>::max(), std::numeric_limits<long>::min() + 1 };
+    for (const long x : small)
+    {
+        assert(bn128_ate_Fq(x).as_bigint() == bn128_Fq(x).as_bigint());
+    }
+
+    for (size_t i = 0; i < 20; ++i)
+    {
+        const bn128_Fq a = bn128_Fq::random_element();
+        const bn128_Fq b = bn128_Fq::random_element();
+        const bn128_ate_Fq a_ate(a.as_bigint()), b_ate(b.as_bigint());
+        assert(a_ate.as_bigint() == a.as_bigint());
+        assert((a_ate * b_ate).as_bigint() == (a * b).as_bigint());
+        assert((a_ate - b_ate).as_bigint() == (a - b).as_bigint());
+    }
+}
+#endif
+
 template<typename ppT>
 void test_all_fields()
 {
@@ -151,6 +384,14 @@ void test_all_fields()
     test_Frobenius<Fqk<ppT> >();
 
     test_unitary_inverse<Fqk<ppT> >();
+
+    test_inverse<Fr<ppT> >();
+    test_inverse<Fq<ppT> >();
+
+    test_batch_mul<Fr<ppT> >();
+    test_batch_mul<Fq<ppT> >();
+    test_modular_arithmetic<Fr<ppT> >();
+    test_modular_arithmetic<Fq<ppT> >();
 }
 
 template<typename Fp4T>
@@ -237,11 +478,16 @@ int main()
     test_field<alt_bn128_Fq6>();
     test_Frobenius<alt_bn128_Fq6>();
     test_all_fields<alt_bn128_pp>();
+    test_lazy_reduction<alt_bn128_Fq12>();
+    test_cyclotomic_squaring<Fqk<alt_bn128_pp> >();
 
 #ifdef CURVE_BN128       // BN128 has fancy dependencies so it may be disabled
     bn128_pp::init_public_params();
     test_field<Fr<bn128_pp> >();
     test_field<Fq<bn128_pp> >();
+    test_bn128_ate_field<bn128_ate_Fq>();
+    test_bn128_ate_field<bn128_ate_Fq2>();
+    test_bn128_ate_Fq_conversion();
 #endif
 }
 
@@ -13,8 +13,13 @@
 #define MULTIEXP_HPP_
 
 #include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
 #include <vector>
 
+#include <libff/algebra/fields/bigint.hpp>
+
 namespace libff {
 
 enum multi_exp_method {
@@ -43,7 +48,27 @@ enum multi_exp_method {
   * Requires that T implements .dbl() (and, if USE_MIXED_ADDITION is defined,
   * .to_special(), .mixed_add(), and batch_to_special()).
   */
- multi_exp_method_BDLO12
+ multi_exp_method_BDLO12,
+ /**
+  * Pippenger's algorithm with signed digits: each scalar is recoded in base
+  * 2^c with digits in [-2^(c-1), 2^(c-1)], so that a window only needs
+  * 2^(c-1) buckets, negative digits adding the negated base. The window size
+  * c is chosen from the number of scalars and their bit length, and when
+  * compiled with MULTICORE the windows are processed in parallel.
+  * When compiled with USE_MIXED_ADDITION, assumes input is in special form.
+  * Requires that T implements .dbl() (and, if USE_MIXED_ADDITION is defined,
+  * .mixed_add()).
+  */
+ multi_exp_method_pippenger_signed,
+ /**
+  * Chooses between multi_exp_method_bos_coster and
+  * multi_exp_method_pippenger_signed from the number of scalars and their
+  * maximum bit length: Bos-Coster for at most 64 scalars (128 if some have
+  * more than 64 bits), and signed Pippenger otherwise, whose windows are then
+  * sized for that bit length (e.g. two windows for 16-bit scalars).
+  * Has the requirements of both methods.
+  */
+ multi_exp_method_auto
 };
 
 /**
@@ -61,6 +86,117 @@ T multi_exp(typename std::vector<T>::const_iterator vec_start,
             const size_t chunks);
 
 
+/**
+ * Random access iterator over elements of type T that are stride bytes apart
+ * in memory, e.g. one field of an array of records or a mapped file; stride
+ * must be a positive multiple of alignof(T).
+ */
+template<typename T>
+class strided_iterator {
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T* pointer;
+    typedef const T& reference;
+
+    strided_iterator() : ptr(nullptr), stride(0) {};
+    strided_iterator(const T *ptr, const size_t stride) :
+        ptr(reinterpret_cast<const char*>(ptr)), stride(stride) {};
+
+    const T& operator*() const { return *reinterpret_cast<const T*>(ptr); }
+    const T* operator->() const { return reinterpret_cast<const T*>(ptr); }
+    const T& operator[](const difference_type i) const { return *(*this + i); }
+
+    strided_iterator& operator++() { ptr += stride; return *this; }
+    strided_iterator& operator--() { ptr -= stride; return *this; }
+    strided_iterator operator++(int) { strided_iterator res = *this; ++(*this); return res; }
+    strided_iterator operator--(int) { strided_iterator res = *this; --(*this); return res; }
+    strided_iterator& operator+=(const difference_type i) { ptr += i * (difference_type)stride; return *this; }
+    strided_iterator& operator-=(const difference_type i) { ptr -= i * (difference_type)stride; return *this; }
+    strided_iterator operator+(const difference_type i) const { strided_iterator res = *this; return res += i; }
+    strided_iterator operator-(const difference_type i) const { strided_iterator res = *this; return res -= i; }
+    friend strided_iterator operator+(const difference_type i, const strided_iterator &it) { return it + i; }
+    difference_type operator-(const strided_iterator &other) const { return (ptr - other.ptr) / (difference_type)stride; }
+
+    bool operator==(const strided_iterator &other) const { return ptr == other.ptr; }
+    bool operator!=(const strided_iterator &other) const { return ptr != other.ptr; }
+    bool operator<(const strided_iterator &other) const { return ptr < other.ptr; }
+    bool operator>(const strided_iterator &other) const { return ptr > other.ptr; }
+    bool operator<=(const strided_iterator &other) const { return ptr <= other.ptr; }
+    bool operator>=(const strided_iterator &other) const { return ptr >= other.ptr; }
+private:
+    const char *ptr;
+    size_t stride;
+};
+
+/**
+ * Random access iterator over points of T stored as affine coordinates: X
+ * followed by Y, both of type CoordT, every stride bytes. Points are built on
+ * the fly with Z = 1, so they are in special form, and cannot be zero.
+ */
+template<typename T, typename CoordT>
+class affine_point_iterator {
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T* pointer;
+    typedef T reference;
+
+    affine_point_iterator() {};
+    affine_point_iterator(const CoordT *coordinates, const size_t stride) : it(coordinates, stride) {};
+
+    T operator*() const { return T(it[0], (&it[0])[1], CoordT::one()); }
+    T operator[](const difference_type i) const { return *(*this + i); }
+
+    affine_point_iterator& operator++() { ++it; return *this; }
+    affine_point_iterator& operator--() { --it; return *this; }
+    affine_point_iterator operator++(int) { affine_point_iterator res = *this; ++it; return res; }
+    affine_point_iterator operator--(int) { affine_point_iterator res = *this; --it; return res; }
+    affine_point_iterator& operator+=(const difference_type i) { it += i; return *this; }
+    affine_point_iterator& operator-=(const difference_type i) { it -= i; return *this; }
+    affine_point_iterator operator+(const difference_type i) const { affine_point_iterator res = *this; return res += i; }
+    affine_point_iterator operator-(const difference_type i) const { affine_point_iterator res = *this; return res -= i; }
+    friend affine_point_iterator operator+(const difference_type i, const affine_point_iterator &p) { return p + i; }
+    difference_type operator-(const affine_point_iterator &other) const { return it - other.it; }
+
+    bool operator==(const affine_point_iterator &other) const { return it == other.it; }
+    bool operator!=(const affine_point_iterator &other) const { return it != other.it; }
+    bool operator<(const affine_point_iterator &other) const { return it < other.it; }
+    bool operator>(const affine_point_iterator &other) const { return it > other.it; }
+    bool operator<=(const affine_point_iterator &other) const { return it <= other.it; }
+    bool operator>=(const affine_point_iterator &other) const { return it >= other.it; }
+private:
+    strided_iterator<CoordT> it;
+};
+
+/**
+ * As multi_exp, over length bases and scalars read in place: the i-th base is
+ * at (const char*) bases + i * bases_stride, and the i-th scalar at
+ * (const char*) scalars + i * scalars_stride.
+ */
+template<typename T, typename FieldT, multi_exp_method Method>
+T multi_exp(const T *bases,
+            const size_t bases_stride,
+            const FieldT *scalars,
+            const size_t scalars_stride,
+            const size_t length,
+            const size_t chunks);
+
+/**
+ * As above, for bases stored as affine coordinates (X, Y) with Z = 1 implied,
+ * the i-th X being at (const char*) coordinates + i * point_stride; CoordT is
+ * the field of the coordinates, e.g. alt_bn128_Fq2 for alt_bn128_G2.
+ */
+template<typename T, typename FieldT, multi_exp_method Method, typename CoordT>
+T multi_exp_affine(const CoordT *coordinates,
+                   const size_t point_stride,
+                   const FieldT *scalars,
+                   const size_t scalars_stride,
+                   const size_t length,
+                   const size_t chunks);
+
 /**
  * A variant of multi_exp that takes advantage of the method mixed_add (instead
  * of the operator '+').
@@ -74,6 +210,93 @@ T multi_exp_with_mixed_addition(typename std::vector<T>::const_iterator vec_star
                                 typename std::vector<FieldT>::const_iterator scalar_end,
                                 const size_t chunks);
 
+template<mp_size_t n>
+class ordered_exponent;
+
+/**
+ * Scratch space for the multi_exp and multi_exp_with_mixed_addition variants
+ * below, which reuse it instead of allocating: calls on at most max_length
+ * elements perform no heap allocation, and longer ones grow it.
+ */
+template<typename T, typename FieldT>
+struct multi_exp_workspace {
+    std::vector<T> bases; // the bases kept by multi_exp_with_mixed_addition
+    std::vector<FieldT> scalars;
+    std::vector<T> g; // working copy of the bases for Bos-Coster
+    std::vector<ordered_exponent<FieldT::num_limbs> > opt_q;
+    std::vector<bigint<FieldT::num_limbs> > exponents; // the scalars out of Montgomery form
+    std::vector<T> buckets;
+    std::vector<long> naf;
+    std::vector<T> table;
+
+    explicit multi_exp_workspace(const size_t max_length);
+};
+
+/**
+ * As multi_exp, on a single thread, using workspace for all intermediate
+ * storage. Method must be multi_exp_method_bos_coster,
+ * multi_exp_method_pippenger_signed or multi_exp_method_auto.
+ */
+template<typename T, typename FieldT, multi_exp_method Method>
+T multi_exp(typename std::vector<T>::const_iterator vec_start,
+            typename std::vector<T>::const_iterator vec_end,
+            typename std::vector<FieldT>::const_iterator scalar_start,
+            typename std::vector<FieldT>::const_iterator scalar_end,
+            multi_exp_workspace<T, FieldT> &workspace);
+
+/**
+ * As multi_exp_with_mixed_addition, on a single thread and without profiling
+ * output, using workspace for all intermediate storage.
+ */
+template<typename T, typename FieldT, multi_exp_method Method>
+T multi_exp_with_mixed_addition(typename std::vector<T>::const_iterator vec_start,
+                                typename std::vector<T>::const_iterator vec_end,
+                                typename std::vector<FieldT>::const_iterator scalar_start,
+                                typename std::vector<FieldT>::const_iterator scalar_end,
+                                multi_exp_workspace<T, FieldT> &workspace);
+
+/**
+ * Scalars recoded once for multi_exp_method_pippenger_signed: their signed
+ * base 2^window digits, for a window sized for their number and maximum bit
+ * length. A multi_exp over recoded scalars skips the conversion out of
+ * Montgomery form and the recoding, so that the same scalars can be used
+ * against many sets of bases.
+ */
+template<typename FieldT>
+class recoded_scalars {
+public:
+    recoded_scalars() : length(0), window(2), num_windows(0) {};
+    explicit recoded_scalars(const std::vector<FieldT> &scalars);
+
+    size_t size() const { return length; }
+    size_t window_size() const { return window; }
+    size_t window_count() const { return num_windows; }
+    /* digit k of scalar i, in [-2^(window-1), 2^(window-1)] */
+    long digit(const size_t i, const size_t k) const { return digits[k * length + i]; }
+private:
+    size_t length;
+    size_t window;
+    size_t num_windows; // 0 if all scalars are zero
+    std::vector<int32_t> digits; // window-major: digits[k*length + i]
+};
+
+/**
+ * As multi_exp with multi_exp_method_pippenger_signed, for scalars recoded
+ * beforehand; the number of bases must be scalars.size().
+ */
+template<typename T, typename FieldT>
+T multi_exp(typename std::vector<T>::const_iterator vec_start,
+            typename std::vector<T>::const_iterator vec_end,
+            const recoded_scalars<FieldT> &scalars);
+
+/**
+ * As above, over scalars.size() bases read in place, bases_stride bytes apart.
+ */
+template<typename T, typename FieldT>
+T multi_exp(const T *bases,
+            const size_t bases_stride,
+            const recoded_scalars<FieldT> &scalars);
+
 /**
  * A convenience function for calculating a pure inner product, where the
  * more complicated methods are not required.
@@ -123,6 +346,66 @@ std::vector<T> batch_exp_with_coeff(const size_t scalar_size,
                                     const FieldT &coeff,
                                     const std::vector<FieldT> &v);
 
+/**
+ * Computes v[i] * g for every i, for scalars of at most scalar_size bits, in
+ * special form. A table of the signed multiples of g needed by a window size
+ * chosen for v.size() is built once; then the scalars are split between
+ * threads (when compiled with MULTICORE), each converting its share of the
+ * results to special form with a single field inversion.
+ */
+template<typename T, typename FieldT>
+std::vector<T> batch_exp_to_special(const size_t scalar_size,
+                                    const T &g,
+                                    const std::vector<FieldT> &v);
+
+/* largest window of a fixed_base_multi_exp_table, which then has 2^15 buckets */
+const size_t fixed_base_multi_exp_max_window = 16;
+
+/**
+ * Precomputation for multi-exponentiations over fixed bases: the shifts
+ * 2^(k*window) * bases[i], in special form, for each window k of the signed
+ * recoding used by multi_exp_method_pippenger_signed. A multi-exponentiation
+ * over these bases then needs bucket additions only, and no doublings.
+ */
+template<typename T>
+struct fixed_base_multi_exp_table {
+    size_t window;
+    size_t num_windows;
+    std::vector<T> shifts; // shifts[i*num_windows + k] = 2^(k*window) * bases[i]
+
+    size_t num_bases() const { return shifts.size() / num_windows; }
+};
+
+template<typename T>
+std::ostream& operator<<(std::ostream &out, const fixed_base_multi_exp_table<T> &table);
+/*
+ * sets failbit on in if the window is not in [1, fixed_base_multi_exp_max_window],
+ * or if the number of shifts is not a multiple of the number of windows
+ */
+template<typename T>
+std::istream& operator>>(std::istream &in, fixed_base_multi_exp_table<T> &table);
+
+/**
+ * Window size minimizing the number of additions in fixed_base_multi_exp,
+ * for num_bases scalars of scalar_size bits.
+ */
+size_t get_fixed_base_multi_exp_window_size(const size_t num_bases, const size_t scalar_size);
+
+template<typename T>
+fixed_base_multi_exp_table<T> get_fixed_base_multi_exp_table(const size_t scalar_size,
+                                                              const size_t window,
+                                                              const std::vector<T> &bases);
+
+/**
+ * Computes the sum of scalars[i] * bases[i] for the bases of table, whose
+ * scalar_size must be at least the bit length of every scalar.
+ * When compiled with MULTICORE, the scalars are split between threads.
+ * Uses mixed additions when compiled with USE_MIXED_ADDITION.
+ */
+template<typename T, typename FieldT>
+T fixed_base_multi_exp(const fixed_base_multi_exp_table<T> &table,
+                       const std::vector<FieldT> &scalars);
+
 template<typename T>
 void batch_to_special(std::vector<T> &vec);
 
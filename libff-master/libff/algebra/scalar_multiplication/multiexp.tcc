@@ -22,7 +22,9 @@
 #include <libff/algebra/fields/fp_aux.tcc>
 #include <libff/algebra/scalar_multiplication/multiexp.hpp>
 #include <libff/algebra/scalar_multiplication/wnaf.hpp>
+#include <libff/common/parallel.hpp>
 #include <libff/common/profiling.hpp>
+#include <libff/common/serialization.hpp>
 #include <libff/common/utils.hpp>
 
 namespace libff {
@@ -42,7 +44,7 @@ public:
         if (n == 3)
         {
             long res;
-            __asm__
+            __asm__ volatile
                 ("// check for overflow           \n\t"
                  "mov $0, %[res]                  \n\t"
                  ADD_CMP(16)
@@ -54,13 +56,13 @@ public:
                  "done%=:                         \n\t"
                  : [res] "=&r" (res)
                  : [A] "r" (other.r.data), [mod] "r" (this->r.data)
-                 : "cc", "%rax");
+                 : "cc", "memory", "%rax");
             return res;
         }
         else if (n == 4)
         {
             long res;
-            __asm__
+            __asm__ volatile
                 ("// check for overflow           \n\t"
                  "mov $0, %[res]                  \n\t"
                  ADD_CMP(24)
@@ -73,13 +75,13 @@ public:
                  "done%=:                         \n\t"
                  : [res] "=&r" (res)
                  : [A] "r" (other.r.data), [mod] "r" (this->r.data)
-                 : "cc", "%rax");
+                 : "cc", "memory", "%rax");
             return res;
         }
         else if (n == 5)
         {
             long res;
-            __asm__
+            __asm__ volatile
                 ("// check for overflow           \n\t"
                  "mov $0, %[res]                  \n\t"
                  ADD_CMP(32)
@@ -93,7 +95,7 @@ public:
                  "done%=:                         \n\t"
                  : [res] "=&r" (res)
                  : [A] "r" (other.r.data), [mod] "r" (this->r.data)
-                 : "cc", "%rax");
+                 : "cc", "memory", "%rax");
             return res;
         }
         else
@@ -104,6 +106,35 @@ public:
     }
 };
 
+/*
+  The scalar as a bigint, out of Montgomery form. The implementations below
+  also take scalars that multi_exp_chunked has already converted.
+*/
+template<typename ScalarT>
+auto scalar_as_bigint(const ScalarT &x) -> decltype(x.as_bigint())
+{
+    return x.as_bigint();
+}
+
+template<mp_size_t n>
+const bigint<n>& scalar_as_bigint(const bigint<n> &x)
+{
+    return x;
+}
+
+/* and back, for methods that need the field element */
+template<typename FieldT>
+const FieldT& scalar_as_field(const FieldT &x)
+{
+    return x;
+}
+
+template<typename FieldT>
+FieldT scalar_as_field(const bigint<FieldT::num_limbs> &x)
+{
+    return FieldT(x);
+}
+
 /**
  * multi_exp_inner<T, FieldT, Method>() implementes the specified
  * multiexponentiation method.
@@ -117,22 +148,23 @@ public:
  * implementation will be used.
  */
 
-template<typename T, typename FieldT, multi_exp_method Method,
+template<typename T, typename FieldT, multi_exp_method Method, typename BaseIt, typename ScalarIt,
     typename std::enable_if<(Method == multi_exp_method_naive), int>::type = 0>
 T multi_exp_inner(
-    typename std::vector<T>::const_iterator vec_start,
-    typename std::vector<T>::const_iterator vec_end,
-    typename std::vector<FieldT>::const_iterator scalar_start,
-    typename std::vector<FieldT>::const_iterator scalar_end)
+    BaseIt vec_start,
+    BaseIt vec_end,
+    ScalarIt scalar_start,
+    ScalarIt scalar_end)
 {
+    UNUSED(scalar_end);
     T result(T::zero());
 
-    typename std::vector<T>::const_iterator vec_it;
-    typename std::vector<FieldT>::const_iterator scalar_it;
+    BaseIt vec_it = vec_start;
+    ScalarIt scalar_it = scalar_start;
 
-    for (vec_it = vec_start, scalar_it = scalar_start; vec_it != vec_end; ++vec_it, ++scalar_it)
+    for (; vec_it != vec_end; ++vec_it, ++scalar_it)
     {
-        bigint<FieldT::num_limbs> scalar_bigint = scalar_it->as_bigint();
+        const bigint<FieldT::num_limbs> scalar_bigint = scalar_as_bigint(*scalar_it);
         result = result + opt_window_wnaf_exp(*vec_it, scalar_bigint, scalar_bigint.num_bits());
     }
     assert(scalar_it == scalar_end);
@@ -140,35 +172,36 @@ T multi_exp_inner(
     return result;
 }
 
-template<typename T, typename FieldT, multi_exp_method Method,
+template<typename T, typename FieldT, multi_exp_method Method, typename BaseIt, typename ScalarIt,
     typename std::enable_if<(Method == multi_exp_method_naive_plain), int>::type = 0>
 T multi_exp_inner(
-    typename std::vector<T>::const_iterator vec_start,
-    typename std::vector<T>::const_iterator vec_end,
-    typename std::vector<FieldT>::const_iterator scalar_start,
-    typename std::vector<FieldT>::const_iterator scalar_end)
+    BaseIt vec_start,
+    BaseIt vec_end,
+    ScalarIt scalar_start,
+    ScalarIt scalar_end)
 {
+    UNUSED(scalar_end);
     T result(T::zero());
 
-    typename std::vector<T>::const_iterator vec_it;
-    typename std::vector<FieldT>::const_iterator scalar_it;
+    BaseIt vec_it = vec_start;
+    ScalarIt scalar_it = scalar_start;
 
-    for (vec_it = vec_start, scalar_it = scalar_start; vec_it != vec_end; ++vec_it, ++scalar_it)
+    for (; vec_it != vec_end; ++vec_it, ++scalar_it)
     {
-        result = result + (*scalar_it) * (*vec_it);
+        result = result + scalar_as_field<FieldT>(*scalar_it) * (*vec_it);
     }
     assert(scalar_it == scalar_end);
 
     return result;
 }
 
-template<typename T, typename FieldT, multi_exp_method Method,
+template<typename T, typename FieldT, multi_exp_method Method, typename BaseIt, typename ScalarIt,
     typename std::enable_if<(Method == multi_exp_method_BDLO12), int>::type = 0>
 T multi_exp_inner(
-    typename std::vector<T>::const_iterator bases,
-    typename std::vector<T>::const_iterator bases_end,
-    typename std::vector<FieldT>::const_iterator exponents,
-    typename std::vector<FieldT>::const_iterator exponents_end)
+    BaseIt bases,
+    BaseIt bases_end,
+    ScalarIt exponents,
+    ScalarIt exponents_end)
 {
     UNUSED(exponents_end);
     size_t length = bases_end - bases;
@@ -177,14 +210,13 @@ T multi_exp_inner(
     size_t log2_length = log2(length);
     size_t c = log2_length - (log2_length / 3 - 2);
 
-    const mp_size_t exp_num_limbs =
-        std::remove_reference<decltype(*exponents)>::type::num_limbs;
+    const mp_size_t exp_num_limbs = FieldT::num_limbs;
     std::vector<bigint<exp_num_limbs> > bn_exponents(length);
     size_t num_bits = 0;
 
     for (size_t i = 0; i < length; i++)
     {
-        bn_exponents[i] = exponents[i].as_bigint();
+        bn_exponents[i] = scalar_as_bigint(exponents[i]);
         num_bits = std::max(num_bits, bn_exponents[i].num_bits());
     }
 
@@ -281,50 +313,301 @@ T multi_exp_inner(
     return result;
 }
 
-template<typename T, typename FieldT, multi_exp_method Method,
-    typename std::enable_if<(Method == multi_exp_method_bos_coster), int>::type = 0>
-T multi_exp_inner(
-    typename std::vector<T>::const_iterator vec_start,
-    typename std::vector<T>::const_iterator vec_end,
-    typename std::vector<FieldT>::const_iterator scalar_start,
-    typename std::vector<FieldT>::const_iterator scalar_end)
+/* the c <= 32 bits of x starting at bit start */
+template<mp_size_t n>
+size_t bigint_window(const bigint<n> &x, const size_t start, const size_t c)
 {
-    const mp_size_t n = std::remove_reference<decltype(*scalar_start)>::type::num_limbs;
+    const size_t limb = start / GMP_NUMB_BITS;
+    const size_t offset = start % GMP_NUMB_BITS;
+    if (limb >= n)
+    {
+        return 0;
+    }
 
-    if (vec_start == vec_end)
+    mp_limb_t bits = x.data[limb] >> offset;
+    if (offset + c > GMP_NUMB_BITS && limb + 1 < n)
+    {
+        bits |= x.data[limb + 1] << (GMP_NUMB_BITS - offset);
+    }
+    return bits & ((1ul << c) - 1);
+}
+
+/*
+  Digit k of the signed base 2^c recoding of x, in [-2^(c-1), 2^(c-1)].
+  The carry into window k is bit kc-1 of x, so digits can be computed
+  independently of each other.
+*/
+template<mp_size_t n>
+long signed_window_digit(const bigint<n> &x, const size_t k, const size_t c)
+{
+    const long raw = bigint_window(x, k * c, c);
+    const long carry = (k == 0 ? 0 : x.test_bit(k * c - 1));
+    return raw + carry - ((raw >> (c - 1)) << c);
+}
+
+/* minimizes the number of additions (num_bits/c + 1) * (length + 2^c) */
+inline size_t pippenger_signed_window_size(const size_t length, const size_t num_bits)
+{
+    size_t best_c = 2;
+    double best_cost = -1;
+    // c = 16 already gives 2^15 buckets per window
+    for (size_t c = 2; c <= 16; ++c)
+    {
+        const double cost = (double)(num_bits / c + 1) * (length + (1ul << c));
+        if (best_cost < 0 || cost < best_cost)
+        {
+            best_c = c;
+            best_cost = cost;
+        }
+    }
+    return best_c;
+}
+
+/*
+  sum_j (j+1) * B_j over the buckets j in [lo, hi), where B_j is the sum of
+  the bases i whose digit(i) is +-(j+1), negated for negative digits.
+  buckets is scratch space of hi - lo elements.
+*/
+template<typename T, typename BaseIt, typename DigitFn>
+T pippenger_signed_bucket_sum_digits(BaseIt bases,
+                                     const DigitFn &digit_of,
+                                     const size_t length,
+                                     const size_t lo,
+                                     const size_t hi,
+                                     std::vector<T> &buckets)
+{
+    std::fill(buckets.begin(), buckets.begin() + (hi - lo), T::zero());
+
+    for (size_t i = 0; i < length; i++)
+    {
+        const long digit = digit_of(i);
+        const size_t j = (digit > 0 ? digit : -digit) - 1;
+        if (digit == 0 || j < lo || j >= hi)
+        {
+            continue;
+        }
+
+        T &bucket = buckets[j - lo];
+#ifdef USE_MIXED_ADDITION
+        bucket = (digit > 0 ? bucket.mixed_add(bases[i]) : bucket.mixed_add(-bases[i]));
+#else
+        bucket = (digit > 0 ? bucket + bases[i] : bucket - bases[i]);
+#endif
+    }
+
+    // as a sum of running sums, plus lo times their total
+    T result = T::zero();
+    T running_sum = T::zero();
+    for (size_t j = hi - lo; j-- > 0; )
+    {
+        running_sum = running_sum + buckets[j];
+        result = result + running_sum;
+    }
+    if (lo > 0)
+    {
+        result = result + bigint<1>(lo) * running_sum;
+    }
+
+    return result;
+}
+
+/* as above, for digit k of the signed base 2^c recoding of each exponent */
+template<typename T, mp_size_t n, typename BaseIt>
+T pippenger_signed_bucket_sum(BaseIt bases,
+                              const std::vector<bigint<n> > &exponents,
+                              const size_t length,
+                              const size_t k,
+                              const size_t c,
+                              const size_t lo,
+                              const size_t hi,
+                              std::vector<T> &buckets)
+{
+    return pippenger_signed_bucket_sum_digits(
+        bases, [&](const size_t i) { return signed_window_digit(exponents[i], k, c); },
+        length, lo, hi, buckets);
+}
+
+/*
+  Combines the windows of a signed Pippenger multi-exponentiation, where
+  bucket_sum(k, lo, hi, buckets) is the sum over buckets [lo, hi) of window k.
+  Windows, and bucket ranges within them when there are fewer windows than
+  workers, are run as parallel tasks.
+*/
+template<typename T, typename BucketSum>
+T pippenger_signed_combine(const size_t num_windows,
+                           const size_t c,
+                           const BucketSum &bucket_sum)
+{
+    const size_t num_buckets = 1ul << (c - 1);
+
+    const size_t splits = std::min(num_buckets, (parallel_num_workers() + num_windows - 1) / num_windows);
+    std::vector<T> partial(num_windows * splits, T::zero());
+
+    parallel_for_tasks(num_windows * splits, [&](const size_t task) {
+        const size_t k = task / splits;
+        const size_t lo = (task % splits) * num_buckets / splits;
+        const size_t hi = (task % splits + 1) * num_buckets / splits;
+
+        std::vector<T> buckets(hi - lo);
+        partial[task] = bucket_sum(k, lo, hi, buckets);
+    });
+
+    std::vector<T> window_sums(num_windows, T::zero());
+    for (size_t k = 0; k < num_windows; ++k)
+    {
+        for (size_t s = 0; s < splits; ++s)
+        {
+            window_sums[k] = window_sums[k] + partial[k * splits + s];
+        }
+    }
+
+    T result = window_sums[num_windows - 1];
+    for (size_t k = num_windows - 1; k-- > 0; )
+    {
+        for (size_t i = 0; i < c; i++)
+        {
+            result = result.dbl();
+        }
+        result = result + window_sums[k];
+    }
+
+    return result;
+}
+
+/*
+  Sets bn_exponents to the scalars as bigints and returns the largest bit
+  length among them, so that callers convert out of Montgomery form once.
+*/
+template<mp_size_t n, typename ScalarIt>
+size_t scalars_as_bigints(ScalarIt scalar_start,
+                          const size_t length,
+                          std::vector<bigint<n> > &bn_exponents)
+{
+    bn_exponents.clear();
+    size_t num_bits = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        bn_exponents.emplace_back(scalar_as_bigint(scalar_start[i]));
+        num_bits = std::max(num_bits, bn_exponents[i].num_bits());
+    }
+    return num_bits;
+}
+
+/* signed Pippenger on scalars already converted by scalars_as_bigints */
+template<typename T, mp_size_t n, typename BaseIt>
+T pippenger_signed_converted(BaseIt bases,
+                             const std::vector<bigint<n> > &bn_exponents,
+                             const size_t num_bits)
+{
+    const size_t length = bn_exponents.size();
+    if (num_bits == 0)
     {
         return T::zero();
     }
 
-    if (vec_start + 1 == vec_end)
+    const size_t c = pippenger_signed_window_size(length, num_bits);
+    // one more window for the carry out of the top one
+    const size_t num_windows = num_bits / c + 1;
+
+    return pippenger_signed_combine<T>(num_windows, c,
+        [&](const size_t k, const size_t lo, const size_t hi, std::vector<T> &buckets) {
+            return pippenger_signed_bucket_sum<T, n>(bases, bn_exponents, length, k, c, lo, hi, buckets);
+        });
+}
+
+/* as above, serially and with the buckets of a workspace */
+template<typename T, mp_size_t n, typename BaseIt>
+T pippenger_signed_converted(BaseIt bases,
+                             const std::vector<bigint<n> > &bn_exponents,
+                             const size_t num_bits,
+                             std::vector<T> &buckets)
+{
+    const size_t length = bn_exponents.size();
+    if (num_bits == 0)
     {
-        return (*scalar_start)*(*vec_start);
+        return T::zero();
     }
 
-    std::vector<ordered_exponent<n> > opt_q;
-    const size_t vec_len = scalar_end - scalar_start;
-    const size_t odd_vec_len = (vec_len % 2 == 1 ? vec_len : vec_len + 1);
-    opt_q.reserve(odd_vec_len);
-    std::vector<T> g;
-    g.reserve(odd_vec_len);
+    // grows the buckets if the workspace was sized for fewer elements
+    const size_t c = pippenger_signed_window_size(length, num_bits);
+    const size_t num_buckets = 1ul << (c - 1);
+    buckets.resize(num_buckets);
+
+    const size_t num_windows = num_bits / c + 1;
+    T result = T::zero();
+    for (size_t k = num_windows; k-- > 0; )
+    {
+        if (k < num_windows - 1)
+        {
+            for (size_t i = 0; i < c; i++)
+            {
+                result = result.dbl();
+            }
+        }
+        result = result + pippenger_signed_bucket_sum<T, n>(
+            bases, bn_exponents, length, k, c, 0, num_buckets, buckets);
+    }
 
-    typename std::vector<T>::const_iterator vec_it;
-    typename std::vector<FieldT>::const_iterator scalar_it;
+    return result;
+}
+
+template<typename T, typename FieldT, multi_exp_method Method, typename BaseIt, typename ScalarIt,
+    typename std::enable_if<(Method == multi_exp_method_pippenger_signed), int>::type = 0>
+T multi_exp_inner(
+    BaseIt bases,
+    BaseIt bases_end,
+    ScalarIt exponents,
+    ScalarIt exponents_end)
+{
+    UNUSED(exponents_end);
+    std::vector<bigint<FieldT::num_limbs> > bn_exponents;
+    const size_t num_bits = scalars_as_bigints(exponents, bases_end - bases, bn_exponents);
+    return pippenger_signed_converted<T>(bases, bn_exponents, num_bits);
+}
+
+/*
+  Sets g to a copy of the bases and opt_q to a heap of the exponents, both
+  padded with a zero to an odd size, as bos_coster_reduce expects.
+*/
+template<typename T, typename FieldT, mp_size_t n, typename BaseIt, typename ScalarIt>
+void bos_coster_fill(BaseIt vec_start,
+                     BaseIt vec_end,
+                     ScalarIt scalar_start,
+                     std::vector<T> &g,
+                     std::vector<ordered_exponent<n> > &opt_q)
+{
+    g.clear();
+    opt_q.clear();
+
+    BaseIt vec_it = vec_start;
+    ScalarIt scalar_it = scalar_start;
     size_t i;
-    for (i=0, vec_it = vec_start, scalar_it = scalar_start; vec_it != vec_end; ++vec_it, ++scalar_it, ++i)
+    for (i=0; vec_it != vec_end; ++vec_it, ++scalar_it, ++i)
     {
         g.emplace_back(*vec_it);
 
-        opt_q.emplace_back(ordered_exponent<n>(i, scalar_it->as_bigint()));
+        opt_q.emplace_back(ordered_exponent<n>(i, scalar_as_bigint(*scalar_it)));
     }
     std::make_heap(opt_q.begin(),opt_q.end());
-    assert(scalar_it == scalar_end);
 
-    if (vec_len != odd_vec_len)
+    if (g.size() % 2 == 0)
     {
         g.emplace_back(T::zero());
-        opt_q.emplace_back(ordered_exponent<n>(odd_vec_len - 1, bigint<n>(0ul)));
+        opt_q.emplace_back(ordered_exponent<n>(g.size() - 1, bigint<n>(0ul)));
     }
+}
+
+/*
+  The Bos-Coster loop proper, on bases g and the heap opt_q of odd size; g and
+  opt_q are overwritten, and naf and table are scratch space for the wNAF
+  exponentiations.
+*/
+template<typename T, mp_size_t n>
+T bos_coster_reduce(std::vector<T> &g,
+                    std::vector<ordered_exponent<n> > &opt_q,
+                    std::vector<long> &naf,
+                    std::vector<T> &table)
+{
     assert(g.size() % 2 == 1);
     assert(opt_q.size() == g.size());
 
@@ -340,7 +623,7 @@ T multi_exp_inner(
         if (b.r.is_zero())
         {
             // opt_result = opt_result + (a.r * g[a.idx]);
-            opt_result = opt_result + opt_window_wnaf_exp(g[a.idx], a.r, abits);
+            opt_result = opt_result + opt_window_wnaf_exp(g[a.idx], a.r, abits, naf, table);
             break;
         }
 
@@ -354,7 +637,7 @@ T multi_exp_inner(
               subtracting b from a multiple times, so let's do it directly
             */
             // opt_result = opt_result + (a.r * g[a.idx]);
-            opt_result = opt_result + opt_window_wnaf_exp(g[a.idx], a.r, abits);
+            opt_result = opt_result + opt_window_wnaf_exp(g[a.idx], a.r, abits, naf, table);
 #ifdef DEBUG
             printf("Skipping the following pair (%zu bit number vs %zu bit):\n", abits, bbits);
             a.r.print();
@@ -373,7 +656,7 @@ T multi_exp_inner(
 
         /* heapify A down */
         size_t a_pos = 0;
-        while (2*a_pos + 2< odd_vec_len)
+        while (2*a_pos + 2 < opt_q.size())
         {
             // this is a max-heap so to maintain a heap property we swap with the largest of the two
             if (opt_q[2*a_pos+1] < opt_q[2*a_pos+2])
@@ -399,12 +682,136 @@ T multi_exp_inner(
     return opt_result;
 }
 
-template<typename T, typename FieldT, multi_exp_method Method>
-T multi_exp(typename std::vector<T>::const_iterator vec_start,
-            typename std::vector<T>::const_iterator vec_end,
-            typename std::vector<FieldT>::const_iterator scalar_start,
-            typename std::vector<FieldT>::const_iterator scalar_end,
-            const size_t chunks)
+template<typename T, typename FieldT, multi_exp_method Method, typename BaseIt, typename ScalarIt,
+    typename std::enable_if<(Method == multi_exp_method_bos_coster), int>::type = 0>
+T multi_exp_inner(
+    BaseIt vec_start,
+    BaseIt vec_end,
+    ScalarIt scalar_start,
+    ScalarIt scalar_end)
+{
+    const mp_size_t n = FieldT::num_limbs;
+
+    if (vec_start == vec_end)
+    {
+        return T::zero();
+    }
+
+    if (vec_start + 1 == vec_end)
+    {
+        return (*scalar_start)*(*vec_start);
+    }
+
+    const size_t vec_len = scalar_end - scalar_start;
+    const size_t odd_vec_len = (vec_len % 2 == 1 ? vec_len : vec_len + 1);
+    std::vector<ordered_exponent<n> > opt_q;
+    opt_q.reserve(odd_vec_len);
+    std::vector<T> g;
+    g.reserve(odd_vec_len);
+
+    bos_coster_fill<T, FieldT, n>(vec_start, vec_end, scalar_start, g, opt_q);
+
+    std::vector<long> naf;
+    std::vector<T> table;
+    return bos_coster_reduce(g, opt_q, naf, table);
+}
+
+template<typename T, typename FieldT, multi_exp_method Method, typename BaseIt, typename ScalarIt,
+    typename std::enable_if<(Method == multi_exp_method_bos_coster), int>::type = 0>
+T multi_exp_inner(
+    BaseIt vec_start,
+    BaseIt vec_end,
+    ScalarIt scalar_start,
+    ScalarIt scalar_end,
+    multi_exp_workspace<T, FieldT> &workspace)
+{
+    UNUSED(scalar_end);
+
+    if (vec_start == vec_end)
+    {
+        return T::zero();
+    }
+
+    if (vec_start + 1 == vec_end)
+    {
+        return (*scalar_start)*(*vec_start);
+    }
+
+    bos_coster_fill<T, FieldT, FieldT::num_limbs>(vec_start, vec_end, scalar_start, workspace.g, workspace.opt_q);
+    return bos_coster_reduce(workspace.g, workspace.opt_q, workspace.naf, workspace.table);
+}
+
+template<typename T, typename FieldT, multi_exp_method Method, typename BaseIt, typename ScalarIt,
+    typename std::enable_if<(Method == multi_exp_method_pippenger_signed), int>::type = 0>
+T multi_exp_inner(
+    BaseIt bases,
+    BaseIt bases_end,
+    ScalarIt exponents,
+    ScalarIt exponents_end,
+    multi_exp_workspace<T, FieldT> &workspace)
+{
+    UNUSED(exponents_end);
+    const size_t num_bits = scalars_as_bigints(exponents, bases_end - bases, workspace.exponents);
+    return pippenger_signed_converted<T>(bases, workspace.exponents, num_bits, workspace.buckets);
+}
+
+/* the largest number of scalars for which multi_exp_method_auto uses Bos-Coster */
+inline size_t multi_exp_auto_bos_coster_max_length(const size_t num_bits)
+{
+    // crossover measured on alt_bn128 G1 and G2
+    return (num_bits > 64 ? 128 : 64);
+}
+
+template<typename T, typename FieldT, multi_exp_method Method, typename BaseIt, typename ScalarIt,
+    typename std::enable_if<(Method == multi_exp_method_auto), int>::type = 0>
+T multi_exp_inner(
+    BaseIt vec_start,
+    BaseIt vec_end,
+    ScalarIt scalar_start,
+    ScalarIt scalar_end)
+{
+    UNUSED(scalar_end);
+    const size_t length = vec_end - vec_start;
+
+    // converted once, for the dispatch and for the method it picks
+    std::vector<bigint<FieldT::num_limbs> > bn_scalars;
+    const size_t num_bits = scalars_as_bigints(scalar_start, length, bn_scalars);
+    if (length <= multi_exp_auto_bos_coster_max_length(num_bits))
+    {
+        return multi_exp_inner<T, FieldT, multi_exp_method_bos_coster>(vec_start, vec_end, bn_scalars.cbegin(), bn_scalars.cend());
+    }
+    return pippenger_signed_converted<T>(vec_start, bn_scalars, num_bits);
+}
+
+template<typename T, typename FieldT, multi_exp_method Method, typename BaseIt, typename ScalarIt,
+    typename std::enable_if<(Method == multi_exp_method_auto), int>::type = 0>
+T multi_exp_inner(
+    BaseIt vec_start,
+    BaseIt vec_end,
+    ScalarIt scalar_start,
+    ScalarIt scalar_end,
+    multi_exp_workspace<T, FieldT> &workspace)
+{
+    UNUSED(scalar_end);
+    const size_t length = vec_end - vec_start;
+
+    // converted once, for the dispatch and for the method it picks
+    const size_t num_bits = scalars_as_bigints(scalar_start, length, workspace.exponents);
+    if (length <= multi_exp_auto_bos_coster_max_length(num_bits))
+    {
+        return multi_exp_inner<T, FieldT, multi_exp_method_bos_coster>(
+            vec_start, vec_end, workspace.exponents.cbegin(), workspace.exponents.cend(), workspace);
+    }
+    return pippenger_signed_converted<T>(vec_start, workspace.exponents, num_bits, workspace.buckets);
+}
+
+/* multi_exp over any random access iterators, see strided_iterator */
+template<typename T, typename FieldT, multi_exp_method Method, typename BaseIt, typename ScalarIt>
+T multi_exp_chunked(BaseIt vec_start,
+                    BaseIt vec_end,
+                    ScalarIt scalar_start,
+                    ScalarIt scalar_end,
+                    const size_t chunks)
 {
     const size_t total = vec_end - vec_start;
     if ((total < chunks) || (chunks == 1))
@@ -414,30 +821,81 @@ T multi_exp(typename std::vector<T>::const_iterator vec_start,
             vec_start, vec_end, scalar_start, scalar_end);
     }
 
-    const size_t one = total/chunks;
+    // the scalars are converted out of Montgomery form once, in parallel, and
+    // the chunks balanced by scalar bit length rather than by count, since the
+    // cost of most methods grows with it (and zero scalars cost nothing)
+    std::vector<bigint<FieldT::num_limbs> > bn_scalars(total);
+    std::vector<size_t> costs(total);
+    const size_t num_blocks = std::min(total, parallel_num_workers());
+    parallel_for_tasks(num_blocks, [&](const size_t b) {
+        for (size_t i = b * total / num_blocks; i < (b + 1) * total / num_blocks; ++i)
+        {
+            bn_scalars[i] = scalar_as_bigint(scalar_start[i]);
+            costs[i] = bn_scalars[i].num_bits();
+        }
+    });
+    const std::vector<size_t> bounds = split_by_cost(costs, chunks);
+    const size_t num_parts = bounds.size() - 1;
 
-    std::vector<T> partial(chunks, T::zero());
+    std::vector<T> partial(num_parts, T::zero());
 
-#ifdef MULTICORE
-#pragma omp parallel for
-#endif
-    for (size_t i = 0; i < chunks; ++i)
-    {
+    parallel_for_tasks(num_parts, [&](const size_t i) {
         partial[i] = multi_exp_inner<T, FieldT, Method>(
-             vec_start + i*one,
-             (i == chunks-1 ? vec_end : vec_start + (i+1)*one),
-             scalar_start + i*one,
-             (i == chunks-1 ? scalar_end : scalar_start + (i+1)*one));
-    }
+             vec_start + bounds[i],
+             vec_start + bounds[i+1],
+             bn_scalars.cbegin() + bounds[i],
+             bn_scalars.cbegin() + bounds[i+1]);
+    });
 
-    T final = T::zero();
+    return parallel_tree_sum(partial);
+}
 
-    for (size_t i = 0; i < chunks; ++i)
-    {
-        final = final + partial[i];
-    }
+template<typename T, typename FieldT, multi_exp_method Method>
+T multi_exp(typename std::vector<T>::const_iterator vec_start,
+            typename std::vector<T>::const_iterator vec_end,
+            typename std::vector<FieldT>::const_iterator scalar_start,
+            typename std::vector<FieldT>::const_iterator scalar_end,
+            const size_t chunks)
+{
+    return multi_exp_chunked<T, FieldT, Method>(vec_start, vec_end, scalar_start, scalar_end, chunks);
+}
 
-    return final;
+template<typename T, typename FieldT, multi_exp_method Method>
+T multi_exp(const T *bases,
+            const size_t bases_stride,
+            const FieldT *scalars,
+            const size_t scalars_stride,
+            const size_t length,
+            const size_t chunks)
+{
+    const strided_iterator<T> bases_start(bases, bases_stride);
+    const strided_iterator<FieldT> scalars_start(scalars, scalars_stride);
+    return multi_exp_chunked<T, FieldT, Method>(bases_start, bases_start + length,
+                                                scalars_start, scalars_start + length, chunks);
+}
+
+template<typename T, typename FieldT, multi_exp_method Method, typename CoordT>
+T multi_exp_affine(const CoordT *coordinates,
+                   const size_t point_stride,
+                   const FieldT *scalars,
+                   const size_t scalars_stride,
+                   const size_t length,
+                   const size_t chunks)
+{
+    const affine_point_iterator<T, CoordT> bases_start(coordinates, point_stride);
+    const strided_iterator<FieldT> scalars_start(scalars, scalars_stride);
+    return multi_exp_chunked<T, FieldT, Method>(bases_start, bases_start + length,
+                                                scalars_start, scalars_start + length, chunks);
+}
+
+template<typename T, typename FieldT, multi_exp_method Method>
+T multi_exp(typename std::vector<T>::const_iterator vec_start,
+            typename std::vector<T>::const_iterator vec_end,
+            typename std::vector<FieldT>::const_iterator scalar_start,
+            typename std::vector<FieldT>::const_iterator scalar_end,
+            multi_exp_workspace<T, FieldT> &workspace)
+{
+    return multi_exp_inner<T, FieldT, Method>(vec_start, vec_end, scalar_start, scalar_end, workspace);
 }
 
 template<typename T, typename FieldT, multi_exp_method Method>
@@ -499,6 +957,136 @@ T multi_exp_with_mixed_addition(typename std::vector<T>::const_iterator vec_star
     return acc + multi_exp<T, FieldT, Method>(g.begin(), g.end(), p.begin(), p.end(), chunks);
 }
 
+template<typename T, typename FieldT, multi_exp_method Method>
+T multi_exp_with_mixed_addition(typename std::vector<T>::const_iterator vec_start,
+                                typename std::vector<T>::const_iterator vec_end,
+                                typename std::vector<FieldT>::const_iterator scalar_start,
+                                typename std::vector<FieldT>::const_iterator scalar_end,
+                                multi_exp_workspace<T, FieldT> &workspace)
+{
+#ifndef NDEBUG
+    assert(std::distance(vec_start, vec_end) == std::distance(scalar_start, scalar_end));
+#else
+    libff::UNUSED(vec_end);
+#endif
+    auto value_it = vec_start;
+    auto scalar_it = scalar_start;
+
+    const FieldT zero = FieldT::zero();
+    const FieldT one = FieldT::one();
+    workspace.bases.clear();
+    workspace.scalars.clear();
+
+    T acc = T::zero();
+
+    for (; scalar_it != scalar_end; ++scalar_it, ++value_it)
+    {
+        if (*scalar_it == zero)
+        {
+            // do nothing
+        }
+        else if (*scalar_it == one)
+        {
+#ifdef USE_MIXED_ADDITION
+            acc = acc.mixed_add(*value_it);
+#else
+            acc = acc + (*value_it);
+#endif
+        }
+        else
+        {
+            workspace.scalars.emplace_back(*scalar_it);
+            workspace.bases.emplace_back(*value_it);
+        }
+    }
+
+    return acc + multi_exp_inner<T, FieldT, Method>(workspace.bases.cbegin(), workspace.bases.cend(),
+                                                    workspace.scalars.cbegin(), workspace.scalars.cend(),
+                                                    workspace);
+}
+
+template<typename T, typename FieldT>
+multi_exp_workspace<T, FieldT>::multi_exp_workspace(const size_t max_length)
+{
+    bases.reserve(max_length);
+    scalars.reserve(max_length);
+    // Bos-Coster pads to an odd length
+    g.reserve(max_length + 1);
+    opt_q.reserve(max_length + 1);
+    exponents.reserve(max_length);
+    buckets.reserve(1ul << (pippenger_signed_window_size(max_length, FieldT::num_bits) - 1));
+    naf.reserve(bigint<FieldT::num_limbs>().max_bits() + 1);
+    if (!T::wnaf_window_table.empty())
+    {
+        table.reserve(1ul << (T::wnaf_window_table.size() - 1));
+    }
+}
+
+template<typename FieldT>
+recoded_scalars<FieldT>::recoded_scalars(const std::vector<FieldT> &scalars) :
+    length(scalars.size()), window(2), num_windows(0)
+{
+    std::vector<bigint<FieldT::num_limbs> > exponents(length);
+    size_t num_bits = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        exponents[i] = scalars[i].as_bigint();
+        num_bits = std::max(num_bits, exponents[i].num_bits());
+    }
+
+    if (num_bits == 0)
+    {
+        return;
+    }
+
+    window = pippenger_signed_window_size(length, num_bits);
+    // one more window for the carry out of the top one
+    num_windows = num_bits / window + 1;
+    digits.resize(num_windows * length);
+    for (size_t k = 0; k < num_windows; ++k)
+    {
+        for (size_t i = 0; i < length; i++)
+        {
+            digits[k * length + i] = signed_window_digit(exponents[i], k, window);
+        }
+    }
+}
+
+template<typename T, typename FieldT, typename BaseIt>
+T multi_exp_recoded(BaseIt bases, const recoded_scalars<FieldT> &scalars)
+{
+    if (scalars.window_count() == 0)
+    {
+        return T::zero();
+    }
+
+    const size_t length = scalars.size();
+    return pippenger_signed_combine<T>(scalars.window_count(), scalars.window_size(),
+        [&](const size_t k, const size_t lo, const size_t hi, std::vector<T> &buckets) {
+            return pippenger_signed_bucket_sum_digits(
+                bases, [&](const size_t i) { return scalars.digit(i, k); },
+                length, lo, hi, buckets);
+        });
+}
+
+template<typename T, typename FieldT>
+T multi_exp(typename std::vector<T>::const_iterator vec_start,
+            typename std::vector<T>::const_iterator vec_end,
+            const recoded_scalars<FieldT> &scalars)
+{
+    assert((size_t)(vec_end - vec_start) == scalars.size());
+    UNUSED(vec_end);
+    return multi_exp_recoded<T>(vec_start, scalars);
+}
+
+template<typename T, typename FieldT>
+T multi_exp(const T *bases,
+            const size_t bases_stride,
+            const recoded_scalars<FieldT> &scalars)
+{
+    return multi_exp_recoded<T>(strided_iterator<T>(bases, bases_stride), scalars);
+}
+
 template <typename T>
 T inner_product(typename std::vector<T>::const_iterator a_start,
                 typename std::vector<T>::const_iterator a_end,
@@ -684,6 +1272,244 @@ std::vector<T> batch_exp_with_coeff(const size_t scalar_size,
     return res;
 }
 
+/* minimizes the number of additions (scalar_size/c + 1) * num_scalars + table size */
+inline size_t batch_exp_signed_window_size(const size_t num_scalars, const size_t scalar_size)
+{
+    size_t best_c = 2;
+    double best_cost = -1;
+    for (size_t c = 2; c <= 16; ++c)
+    {
+        const double num_windows = scalar_size / c + 1;
+        const double cost = num_windows * (num_scalars + (1ul << (c - 1)));
+        if (best_cost < 0 || cost < best_cost)
+        {
+            best_c = c;
+            best_cost = cost;
+        }
+    }
+    return best_c;
+}
+
+template<typename T, typename FieldT>
+std::vector<T> batch_exp_to_special(const size_t scalar_size,
+                                    const T &g,
+                                    const std::vector<FieldT> &v)
+{
+    enter_block("Batch exponentiation to special form");
+    const size_t c = batch_exp_signed_window_size(v.size(), scalar_size);
+    const size_t num_windows = scalar_size / c + 1;
+    const size_t half = 1ul << (c - 1);
+
+    /* table[k*half + j] = (j+1) * 2^(k*c) * g, in special form */
+    std::vector<T> shifts(num_windows, g);
+    for (size_t k = 1; k < num_windows; ++k)
+    {
+        shifts[k] = shifts[k - 1];
+        for (size_t i = 0; i < c; ++i)
+        {
+            shifts[k] = shifts[k].dbl();
+        }
+    }
+    std::vector<T> table(num_windows * half);
+    parallel_for_tasks(num_windows, [&](const size_t k) {
+        table[k * half] = shifts[k];
+        for (size_t j = 1; j < half; ++j)
+        {
+            table[k * half + j] = table[k * half + j - 1] + shifts[k];
+        }
+    });
+    batch_to_special(table);
+
+    /* each part computes its share of the powers, and converts them with one inversion */
+    std::vector<T> res(v.size(), T::zero());
+    const size_t num_parts = std::max<size_t>(1, std::min<size_t>(parallel_num_workers(), v.size()));
+    parallel_for_tasks(num_parts, [&](const size_t part) {
+        const size_t begin = part * v.size() / num_parts;
+        const size_t end = (part + 1) * v.size() / num_parts;
+        std::vector<T> non_zero;
+        non_zero.reserve(end - begin);
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            const bigint<FieldT::num_limbs> scalar = v[i].as_bigint();
+            assert(scalar.num_bits() <= scalar_size);
+
+            T acc = T::zero();
+            for (size_t k = 0; k < num_windows; ++k)
+            {
+                const long digit = signed_window_digit(scalar, k, c);
+                if (digit == 0)
+                {
+                    continue;
+                }
+
+                const T &multiple = table[k * half + (digit > 0 ? digit : -digit) - 1];
+#ifdef USE_MIXED_ADDITION
+                acc = (digit > 0 ? acc.mixed_add(multiple) : acc.mixed_add(-multiple));
+#else
+                acc = (digit > 0 ? acc + multiple : acc - multiple);
+#endif
+            }
+            res[i] = acc;
+            if (!acc.is_zero())
+            {
+                non_zero.emplace_back(acc);
+            }
+        }
+
+        T::batch_to_special_all_non_zeros(non_zero);
+        auto it = non_zero.begin();
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (res[i].is_zero())
+            {
+                res[i].to_special();
+            }
+            else
+            {
+                res[i] = *it++;
+            }
+        }
+    });
+    leave_block("Batch exponentiation to special form");
+
+    return res;
+}
+
+template<typename T>
+std::ostream& operator<<(std::ostream &out, const fixed_base_multi_exp_table<T> &table)
+{
+    out << table.window << "\n";
+    out << table.num_windows << "\n";
+    out << table.shifts;
+
+    return out;
+}
+
+template<typename T>
+std::istream& operator>>(std::istream &in, fixed_base_multi_exp_table<T> &table)
+{
+    in >> table.window;
+    consume_newline(in);
+    if (!in || table.window == 0 || table.window > fixed_base_multi_exp_max_window)
+    {
+        in.setstate(std::ios::failbit);
+        return in;
+    }
+    in >> table.num_windows;
+    consume_newline(in);
+    in >> table.shifts;
+
+    if (table.num_windows == 0 || table.shifts.size() % table.num_windows != 0)
+    {
+        in.setstate(std::ios::failbit);
+    }
+
+    return in;
+}
+
+inline size_t get_fixed_base_multi_exp_window_size(const size_t num_bases, const size_t scalar_size)
+{
+    size_t best_c = 1;
+    double best_cost = -1;
+    // every window adds num_bases shifts into the same 2^(c-1) buckets, which
+    // are summed once at the end for about 2^c additions
+    for (size_t c = 1; c <= fixed_base_multi_exp_max_window; ++c)
+    {
+        const double cost = (double)(scalar_size / c + 1) * num_bases + (1ul << c);
+        if (best_cost < 0 || cost < best_cost)
+        {
+            best_c = c;
+            best_cost = cost;
+        }
+    }
+    return best_c;
+}
+
+template<typename T>
+fixed_base_multi_exp_table<T> get_fixed_base_multi_exp_table(const size_t scalar_size,
+                                                              const size_t window,
+                                                              const std::vector<T> &bases)
+{
+    assert(window >= 1 && window <= fixed_base_multi_exp_max_window);
+    fixed_base_multi_exp_table<T> table;
+    table.window = window;
+    // one more window for the carry out of the top one
+    table.num_windows = scalar_size / window + 1;
+    table.shifts.resize(bases.size() * table.num_windows);
+
+#ifdef MULTICORE
+#pragma omp parallel for
+#endif
+    for (size_t i = 0; i < bases.size(); ++i)
+    {
+        T shift = bases[i];
+        for (size_t k = 0; k < table.num_windows; ++k)
+        {
+            table.shifts[i * table.num_windows + k] = shift;
+            for (size_t j = 0; j < window; ++j)
+            {
+                shift = shift.dbl();
+            }
+        }
+    }
+
+    batch_to_special(table.shifts);
+
+    return table;
+}
+
+template<typename T, typename FieldT>
+T fixed_base_multi_exp(const fixed_base_multi_exp_table<T> &table,
+                       const std::vector<FieldT> &scalars)
+{
+    assert(scalars.size() == table.num_bases());
+    const size_t c = table.window;
+    const size_t num_windows = table.num_windows;
+
+    const size_t num_parts = std::max<size_t>(1, std::min<size_t>(parallel_num_workers(), scalars.size()));
+    std::vector<T> partial(num_parts, T::zero());
+
+    parallel_for_tasks(num_parts, [&](const size_t part) {
+        // buckets[j] holds the sum of the shifts with digit +-(j+1)
+        std::vector<T> buckets(1ul << (c - 1), T::zero());
+
+        const size_t begin = part * scalars.size() / num_parts;
+        const size_t end = (part + 1) * scalars.size() / num_parts;
+        for (size_t i = begin; i < end; ++i)
+        {
+            const bigint<FieldT::num_limbs> scalar = scalars[i].as_bigint();
+            assert(scalar.num_bits() < num_windows * c);
+
+            for (size_t k = 0; k < num_windows; ++k)
+            {
+                const long digit = signed_window_digit(scalar, k, c);
+                if (digit == 0)
+                {
+                    continue;
+                }
+
+                const T &shift = table.shifts[i * num_windows + k];
+                T &bucket = buckets[(digit > 0 ? digit : -digit) - 1];
+#ifdef USE_MIXED_ADDITION
+                bucket = (digit > 0 ? bucket.mixed_add(shift) : bucket.mixed_add(-shift));
+#else
+                bucket = (digit > 0 ? bucket + shift : bucket - shift);
+#endif
+            }
+        }
+
+        T running_sum = T::zero();
+        for (size_t j = buckets.size(); j-- > 0; )
+        {
+            running_sum = running_sum + buckets[j];
+            partial[part] = partial[part] + running_sum;
+        }
+    });
+
+    return parallel_tree_sum(partial);
+}
+
 template<typename T>
 void batch_to_special(std::vector<T> &vec)
 {
@@ -98,6 +98,15 @@ void print_performance_csv(
             fprintf(stderr, "Answers NOT MATCHING (bos coster != djb)\n");
         }
 
+        run_result_t<GroupT> result_pippenger_signed =
+            profile_multiexp<GroupT, FieldT, multi_exp_method_pippenger_signed>(
+                group_elements, scalars);
+        printf("\t%lld", result_pippenger_signed.first); fflush(stdout);
+
+        if (compare_answers && (result_bos_coster.second != result_pippenger_signed.second)) {
+            fprintf(stderr, "Answers NOT MATCHING (bos coster != pippenger signed)\n");
+        }
+
         if (expn <= expn_end_naive) {
             run_result_t<GroupT> result_naive =
                 profile_multiexp<GroupT, FieldT, multi_exp_method_naive>(
@@ -24,18 +24,41 @@ namespace libff {
 template<mp_size_t n>
 std::vector<long> find_wnaf(const size_t window_size, const bigint<n> &scalar);
 
+/**
+ * As above, writing the representation to res, which only allocates if it has
+ * less than scalar.max_bits()+1 capacity.
+ */
+template<mp_size_t n>
+void find_wnaf(const size_t window_size, const bigint<n> &scalar, std::vector<long> &res);
+
 /**
  * In additive notation, use wNAF exponentiation (with the given window size) to compute scalar * base.
  */
 template<typename T, mp_size_t n>
 T fixed_window_wnaf_exp(const size_t window_size, const T &base, const bigint<n> &scalar);
 
+/**
+ * As above, with naf and table as scratch space (of scalar.max_bits()+1 and
+ * 2^(window_size-1) elements), so that nothing is allocated once they are reserved.
+ */
+template<typename T, mp_size_t n>
+T fixed_window_wnaf_exp(const size_t window_size, const T &base, const bigint<n> &scalar,
+                        std::vector<long> &naf, std::vector<T> &table);
+
 /**
  * In additive notation, use wNAF exponentiation (with the window size determined by T) to compute scalar * base.
  */
 template<typename T, mp_size_t n>
 T opt_window_wnaf_exp(const T &base, const bigint<n> &scalar, const size_t scalar_bits);
 
+/**
+ * As above, with scratch space as for fixed_window_wnaf_exp; table needs at
+ * most 2^(T::wnaf_window_table.size()-1) elements.
+ */
+template<typename T, mp_size_t n>
+T opt_window_wnaf_exp(const T &base, const bigint<n> &scalar, const size_t scalar_bits,
+                      std::vector<long> &naf, std::vector<T> &table);
+
 } // libff
 
 #include <libff/algebra/scalar_multiplication/wnaf.tcc>
@@ -20,9 +20,17 @@ namespace libff {
 
 template<mp_size_t n>
 std::vector<long> find_wnaf(const size_t window_size, const bigint<n> &scalar)
+{
+    std::vector<long> res;
+    find_wnaf(window_size, scalar, res);
+    return res;
+}
+
+template<mp_size_t n>
+void find_wnaf(const size_t window_size, const bigint<n> &scalar, std::vector<long> &res)
 {
     const size_t length = scalar.max_bits(); // upper bound
-    std::vector<long> res(length+1);
+    res.assign(length+1, 0);
     bigint<n> c = scalar;
     long j = 0;
     while (!c.is_zero())
@@ -54,15 +62,22 @@ std::vector<long> find_wnaf(const size_t window_size, const bigint<n> &scalar)
 
         mpn_rshift(c.data, c.data, n, 1); // c = c/2
     }
-
-    return res;
 }
 
 template<typename T, mp_size_t n>
 T fixed_window_wnaf_exp(const size_t window_size, const T &base, const bigint<n> &scalar)
 {
-    std::vector<long> naf = find_wnaf(window_size, scalar);
-    std::vector<T> table(1ul<<(window_size-1));
+    std::vector<long> naf;
+    std::vector<T> table;
+    return fixed_window_wnaf_exp(window_size, base, scalar, naf, table);
+}
+
+template<typename T, mp_size_t n>
+T fixed_window_wnaf_exp(const size_t window_size, const T &base, const bigint<n> &scalar,
+                        std::vector<long> &naf, std::vector<T> &table)
+{
+    find_wnaf(window_size, scalar, naf);
+    table.resize(1ul<<(window_size-1));
     T tmp = base;
     T dbl = base.dbl();
     for (size_t i = 0; i < 1ul<<(window_size-1); ++i)
@@ -99,6 +114,15 @@ T fixed_window_wnaf_exp(const size_t window_size, const T &base, const bigint<n>
 
 template<typename T, mp_size_t n>
 T opt_window_wnaf_exp(const T &base, const bigint<n> &scalar, const size_t scalar_bits)
+{
+    std::vector<long> naf;
+    std::vector<T> table;
+    return opt_window_wnaf_exp(base, scalar, scalar_bits, naf, table);
+}
+
+template<typename T, mp_size_t n>
+T opt_window_wnaf_exp(const T &base, const bigint<n> &scalar, const size_t scalar_bits,
+                      std::vector<long> &naf, std::vector<T> &table)
 {
     size_t best = 0;
     for (long i = T::wnaf_window_table.size() - 1; i >= 0; --i)
@@ -112,7 +136,7 @@ T opt_window_wnaf_exp(const T &base, const bigint<n> &scalar, const size_t scala
 
     if (best > 0)
     {
-        return fixed_window_wnaf_exp(best, base, scalar);
+        return fixed_window_wnaf_exp(best, base, scalar, naf, table);
     }
     else
     {
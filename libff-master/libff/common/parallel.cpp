@@ -0,0 +1,164 @@
+/** @file
+ *****************************************************************************
+ Implementation of the thread pool behind parallel_for_tasks under
+ THREAD_POOL, for builds without MULTICORE (OpenMP)
+
+ On first use the pool starts one worker thread per hardware thread, less
+ one for the calling thread, which takes tasks too. A parallel_for_tasks issued from inside a
+ task, or while another thread runs the pool, runs serially on its caller,
+ like a nested OpenMP parallel region.
+
+ See parallel.hpp .
+ *****************************************************************************
+ * @author     This file is part of libff, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#if !defined(MULTICORE) && defined(THREAD_POOL)
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <libff/common/parallel.hpp>
+
+namespace libff {
+
+namespace {
+
+thread_local bool in_thread_pool_task = false;
+
+class thread_pool {
+public:
+    static thread_pool& instance()
+    {
+        static thread_pool pool;
+        return pool;
+    }
+
+    size_t num_workers() const { return workers.size() + 1; }
+
+    void run(const size_t num_tasks, const std::function<void(size_t)> &f)
+    {
+        std::unique_lock<std::mutex> run_lock(run_mutex, std::defer_lock);
+        if (in_thread_pool_task || num_tasks <= 1 || workers.empty() || !run_lock.try_lock())
+        {
+            for (size_t i = 0; i < num_tasks; ++i)
+            {
+                f(i);
+            }
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &f;
+            job_size = num_tasks;
+            next_task = 0;
+            num_busy = workers.size();
+            ++generation;
+        }
+        wake.notify_all();
+
+        in_thread_pool_task = true;
+        take_tasks();
+        in_thread_pool_task = false;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return num_busy == 0; });
+        job = nullptr;
+    }
+
+private:
+    thread_pool()
+    {
+#ifdef PROFILE_OP_COUNTS
+        /* the operation counters are not atomic */
+        const size_t num_threads = 1;
+#else
+        const size_t num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+#endif
+        for (size_t i = 1; i < num_threads; ++i)
+        {
+            workers.emplace_back([this] { work(); });
+        }
+    }
+
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    void take_tasks()
+    {
+        for (size_t i = next_task++; i < job_size; i = next_task++)
+        {
+            (*job)(i);
+        }
+    }
+
+    void work()
+    {
+        in_thread_pool_task = true;
+        unsigned long seen = 0;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this, seen] { return stop || generation != seen; });
+                if (stop)
+                {
+                    return;
+                }
+                seen = generation;
+            }
+
+            take_tasks();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--num_busy == 0)
+            {
+                done.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex run_mutex;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    const std::function<void(size_t)> *job = nullptr;
+    size_t job_size = 0;
+    std::atomic<size_t> next_task{0};
+    size_t num_busy = 0;
+    unsigned long generation = 0;
+    bool stop = false;
+};
+
+} // namespace
+
+size_t thread_pool_num_workers()
+{
+    return thread_pool::instance().num_workers();
+}
+
+void thread_pool_run(const size_t num_tasks, const std::function<void(size_t)> &f)
+{
+    thread_pool::instance().run(num_tasks, f);
+}
+
+} // libff
+#endif // !MULTICORE && THREAD_POOL
@@ -0,0 +1,44 @@
+/** @file
+ *****************************************************************************
+ Declaration of a task executor for parallel loops of unequal iterations
+
+ Tasks are handed out one at a time to whichever thread is idle, so that a
+ few expensive tasks do not leave the other threads waiting: under MULTICORE
+ with OpenMP dynamic scheduling, and under THREAD_POOL on a pool of
+ std::threads (see parallel.cpp). Otherwise, tasks run in order on the
+ calling thread.
+ *****************************************************************************
+ * @author     This file is part of libff, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef PARALLEL_HPP_
+#define PARALLEL_HPP_
+
+#include <cstddef>
+#include <vector>
+
+namespace libff {
+
+/// number of tasks that parallel_for_tasks can run at once
+size_t parallel_num_workers();
+
+/// runs f(i) for every i in [0, num_tasks), in any order
+template<typename F>
+void parallel_for_tasks(const size_t num_tasks, const F &f);
+
+/// the sum of the elements of vec, as a balanced tree of parallel additions; vec is overwritten
+template<typename T>
+T parallel_tree_sum(std::vector<T> &vec);
+
+/**
+ * Splits [0, costs.size()) into at most num_parts consecutive ranges of about
+ * equal total cost, returned as the num_ranges+1 boundaries.
+ */
+std::vector<size_t> split_by_cost(const std::vector<size_t> &costs, const size_t num_parts);
+
+} // libff
+
+#include <libff/common/parallel.tcc>
+#endif // PARALLEL_HPP_
@@ -0,0 +1,105 @@
+/** @file
+ *****************************************************************************
+ Implementation of the task executor
+
+ See parallel.hpp .
+ *****************************************************************************
+ * @author     This file is part of libff, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef PARALLEL_TCC_
+#define PARALLEL_TCC_
+
+#ifdef MULTICORE
+#include <omp.h>
+#elif defined(THREAD_POOL)
+#include <functional>
+#endif
+
+namespace libff {
+
+#if !defined(MULTICORE) && defined(THREAD_POOL)
+/* the thread pool of parallel.cpp */
+size_t thread_pool_num_workers();
+void thread_pool_run(const size_t num_tasks, const std::function<void(size_t)> &f);
+#endif
+
+inline size_t parallel_num_workers()
+{
+#ifdef MULTICORE
+    return omp_get_max_threads();
+#elif defined(THREAD_POOL)
+    return thread_pool_num_workers();
+#else
+    return 1;
+#endif
+}
+
+template<typename F>
+void parallel_for_tasks(const size_t num_tasks, const F &f)
+{
+#ifdef MULTICORE
+#pragma omp parallel for schedule(dynamic, 1)
+    for (size_t i = 0; i < num_tasks; ++i)
+    {
+        f(i);
+    }
+#elif defined(THREAD_POOL)
+    thread_pool_run(num_tasks, std::cref(f));
+#else
+    for (size_t i = 0; i < num_tasks; ++i)
+    {
+        f(i);
+    }
+#endif
+}
+
+template<typename T>
+T parallel_tree_sum(std::vector<T> &vec)
+{
+    if (vec.empty())
+    {
+        return T::zero();
+    }
+
+    for (size_t stride = 1; stride < vec.size(); stride *= 2)
+    {
+        /* vec[2*stride*i] += vec[2*stride*i + stride] */
+        const size_t num_pairs = (vec.size() - stride + 2 * stride - 1) / (2 * stride);
+        parallel_for_tasks(num_pairs, [&vec, stride](const size_t i) {
+            vec[2 * stride * i] = vec[2 * stride * i] + vec[2 * stride * i + stride];
+        });
+    }
+
+    return vec[0];
+}
+
+inline std::vector<size_t> split_by_cost(const std::vector<size_t> &costs, const size_t num_parts)
+{
+    size_t total = 0;
+    for (const size_t c : costs)
+    {
+        total += c;
+    }
+
+    std::vector<size_t> bounds(1, 0);
+    size_t acc = 0;
+    for (size_t i = 0; i < costs.size(); ++i)
+    {
+        acc += costs[i];
+        /* close part p once it holds p/num_parts of the total cost */
+        if (bounds.size() < num_parts && acc * num_parts >= total * bounds.size() && i + 1 < costs.size())
+        {
+            bounds.emplace_back(i + 1);
+        }
+    }
+    bounds.emplace_back(costs.size());
+
+    return bounds;
+}
+
+} // libff
+
+#endif // PARALLEL_TCC_
@@ -154,6 +154,8 @@ contract Compact {
         Pairing.G1Point memory res_u;
         Pairing.G1Point memory res;
 
+        // H(name, i) = (name * i) * P1: signatures must come from compact
+        // built with -DLEGACY_HASH_TO_G1 until this moves to its SvdW hash
         for (uint j = 0; j < c.i.length; j++) {
             h = Pairing.curveMul(Pairing.P1(), (name * c.i[j]));
             h = Pairing.curveMul(h, c.nu[j]);